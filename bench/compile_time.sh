@@ -0,0 +1,54 @@
+#!/usr/bin/env bash
+# Compares the compile time and the total object size of the default, the slim
+# (C_STR_BUILDER_SLIM), and the extern template (C_STR_BUILDER_EXTERN_TEMPLATES)
+# configuration of c_str_builder.hpp across many translation units.
+#
+# usage: bench/compile_time.sh [number_of_TUs] [parallel_jobs]
+#        The compiler is taken from $CXX (default: c++), additional flags from
+#        $CXXFLAGS (default: -O2).
+
+set -eu
+
+tu_count="${1:-200}"
+jobs="${2:-$(getconf _NPROCESSORS_ONLN 2>/dev/null || echo 1)}"
+cxx="${CXX:-c++}"
+cxxflags="${CXXFLAGS:--O2}"
+root="$(cd "$(dirname "$0")/.." && pwd)"
+work="$(mktemp -d)"
+trap 'rm -rf "$work"' EXIT
+
+# every TU uses the builder the way a typical caller does
+for ((idx = 0; idx < tu_count; ++idx)); do
+  cat > "$work/tu_$idx.cpp" <<CPP
+#include <string>
+#include <string_view>
+#include "c_str_builder.hpp"
+
+extern "C" int consume_$idx(const char *);
+
+int call_$idx(const std::string &str, std::string_view view, const char *ptr)
+{
+  return consume_$idx(c_str::builder{ str }.get()) +
+         consume_$idx(c_str::builder{ view }.get()) +
+         consume_$idx(c_str::builder{ ptr }.get());
+}
+CPP
+done
+
+run() {
+  local label="$1"
+  shift
+  local start end
+  start="$(date +%s%N)"
+  find "$work" -name 'tu_*.cpp' -print0 |
+    xargs -0 -P "$jobs" -I{} $cxx -std=c++20 $cxxflags "$@" -I"$root" -c {} -o {}.o
+  end="$(date +%s%N)"
+  printf '%-8s %4d TUs: %8.2f s, %10d bytes of objects\n' "$label" "$tu_count" "$(awk "BEGIN { print ($end - $start) / 1e9 }")" "$(cat "$work"/*.o | wc -c)"
+  rm -f "$work"/*.o
+}
+
+echo "$cxx $cxxflags, $jobs parallel jobs"
+run default
+run slim -DC_STR_BUILDER_SLIM
+cp "$root/c_str_builder.cpp" "$work/tu_instantiations.cpp" # the explicit instantiations are compiled once
+run extern -DC_STR_BUILDER_EXTERN_TEMPLATES
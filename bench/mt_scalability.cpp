@@ -0,0 +1,188 @@
+// Multi-threaded scalability benchmark of builder-heavy workloads.
+//
+// Every thread runs a realistic mix of construction (from unterminated views,
+// terminated strings, pointers, and non-contiguous ranges), copy, move, and
+// swap operations for a fixed time. The throughput is reported per thread
+// count and per builder configuration:
+//   std::allocator      the heap of the C++ runtime (glibc malloc on Linux)
+//   counting            a plain allocator counting allocations in a shared atomic
+//   large_page          c_str::large_page_allocator
+//   padded              c_str::padded_allocator
+//   accounted           c_str::accounting_allocator (shared atomic budget)
+//   memo                c_str::memo_builder (per-thread cache)
+//   shm_arena           c_str::arena_allocator (lock-free allocator in shared memory, POSIX only)
+//
+// build: c++ -std=c++20 -O2 -pthread -I.. mt_scalability.cpp -o mt_scalability
+// usage: mt_scalability [max_threads] [milliseconds_per_run]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../c_str_accounting_allocator.hpp"
+#include "../c_str_builder.hpp"
+#include "../c_str_large_page_allocator.hpp"
+#include "../c_str_memo_builder.hpp"
+#include "../c_str_padded_allocator.hpp"
+#if __has_include(<sys/mman.h>)
+#  include "../c_str_shm_arena.hpp"
+#endif
+
+namespace
+{
+  std::atomic<std::size_t> g_allocations{};
+
+  template<class T>
+  struct counting_allocator
+  {
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    constexpr counting_allocator() noexcept = default;
+
+    template<class U>
+    constexpr counting_allocator(const counting_allocator<U> &) noexcept
+    {
+    }
+
+    T *allocate(const std::size_t count)
+    {
+      g_allocations.fetch_add(1, std::memory_order_relaxed);
+      return std::allocator<T>{}.allocate(count);
+    }
+
+    void deallocate(T *const buf, const std::size_t count) noexcept
+    {
+      std::allocator<T>{}.deallocate(buf, count);
+    }
+
+    friend constexpr bool operator==(const counting_allocator &, const counting_allocator &) noexcept
+    {
+      return true;
+    }
+  };
+
+  // source strings of typical lengths (keys, paths, messages)
+  struct sources
+  {
+    std::vector<std::string> strings{};
+    std::vector<std::string_view> views{};
+    std::vector<std::deque<char>> deques{};
+
+    sources()
+    {
+      for (std::size_t len : { 8U, 16U, 24U, 40U, 64U, 120U, 256U, 1000U })
+        strings.emplace_back(len, static_cast<char>('a' + len % 26));
+
+      for (const auto &str : strings)
+      {
+        views.emplace_back(str.data(), str.size() - 1); // unterminated => copy
+        deques.emplace_back(str.begin(), str.end());
+      }
+    }
+  };
+
+  template<class BuilderT>
+  std::size_t worker(const sources &src, const std::atomic<bool> &stop)
+  {
+    std::size_t ops{};
+    std::size_t sink{};
+    std::vector<BuilderT> keep(16);
+    for (std::size_t idx{}; !stop.load(std::memory_order_relaxed); ++idx)
+    {
+      const auto sel{ idx % src.strings.size() };
+      BuilderT fromView{ src.views[sel] };
+      BuilderT fromString{ src.strings[sel] };
+      BuilderT fromPointer{ src.strings[sel].c_str() };
+      BuilderT copy{ fromView };
+      BuilderT moved{ std::move(copy) };
+      moved.swap(fromString);
+      keep[idx % keep.size()] = std::move(moved); // some builders live longer and are released later
+      ops += 6;
+      if (!(idx & 7))
+      {
+        BuilderT fromDeque{ src.deques[sel] };
+        sink += fromDeque.get()[0];
+        ++ops;
+      }
+
+      sink += static_cast<std::size_t>(fromView.get()[0] + fromPointer.get()[0]);
+    }
+
+    return ops + (sink & 1); // keep `sink` alive
+  }
+
+  template<class BuilderT>
+  double run(const sources &src, const unsigned threadCount, const std::chrono::milliseconds duration)
+  {
+    std::atomic<bool> stop{};
+    std::vector<std::size_t> results(threadCount);
+    std::vector<std::thread> threads{};
+    for (unsigned idx{}; idx < threadCount; ++idx)
+      threads.emplace_back([&, idx] { results[idx] = worker<BuilderT>(src, stop); });
+
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto &thread : threads)
+      thread.join();
+
+    std::size_t total{};
+    for (const auto ops : results)
+      total += ops;
+
+    return static_cast<double>(total) / std::chrono::duration<double>(duration).count();
+  }
+
+  template<class BuilderT>
+  void report(const char *const name, const sources &src, const unsigned maxThreads, const std::chrono::milliseconds duration)
+  {
+    std::printf("%-16s", name);
+    double single{};
+    for (unsigned threadCount{ 1 }; threadCount <= maxThreads; threadCount *= 2)
+    {
+      const auto opsPerSec{ run<BuilderT>(src, threadCount, duration) };
+      if (threadCount == 1)
+        single = opsPerSec;
+
+      std::printf(" | %9.2f Mop/s %5.2fx", opsPerSec / 1e6, opsPerSec / single);
+    }
+
+    std::printf("\n");
+  }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+  const auto hardwareThreads{ (std::max)(1U, std::thread::hardware_concurrency()) };
+  const auto maxThreads{ argc > 1 ? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10)) : hardwareThreads };
+  const std::chrono::milliseconds duration{ argc > 2 ? std::strtol(argv[2], nullptr, 10) : 500 };
+  const sources src{};
+
+  std::printf("%-16s", "threads");
+  for (unsigned threadCount{ 1 }; threadCount <= maxThreads; threadCount *= 2)
+    std::printf(" | %4u thread(s) scaling", threadCount);
+
+  std::printf("\n");
+  report<c_str::builder>("std::allocator", src, maxThreads, duration);
+  g_allocations = 0;
+  report<c_str::basic_builder<char, c_str::if_null::DEF_NULL_BEHAVIOR, counting_allocator<char>>>("counting", src, maxThreads, duration);
+  std::printf("%-16s   %zu allocations\n", "", g_allocations.load());
+  report<c_str::basic_large_builder<char>>("large_page", src, maxThreads, duration);
+  report<c_str::padded_builder>("padded", src, maxThreads, duration);
+  report<c_str::accounted_builder>("accounted", src, maxThreads, duration);
+  report<c_str::memo_builder>("memo", src, maxThreads, duration);
+#if __has_include(<sys/mman.h>)
+  auto arena{ c_str::shm_arena::create(std::size_t{ 256 } << 20) };
+  arena.make_current();
+  report<c_str::basic_arena_builder<char>>("shm_arena", src, maxThreads, duration);
+#endif
+}
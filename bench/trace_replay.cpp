@@ -0,0 +1,451 @@
+// Replay benchmark of recorded builder workloads.
+//
+// A trace recorded with c_str::trace_recorder (see c_str_trace.hpp) is replayed
+// operation by operation against several builder configurations, so library
+// changes and allocator options can be evaluated offline against the shape of
+// a real workload. Construction records are replayed from a source object of
+// the recorded kind and length, copy, move, swap, and destruction records on
+// the objects of the recorded slots. The events of all recorded threads are
+// replayed in their recorded order on a single thread.
+// Without a trace file, a synthetic trace is generated and optionally saved.
+//
+// build: c++ -std=c++20 -O2 -pthread -I.. trace_replay.cpp -o trace_replay
+// usage: trace_replay [trace_file] [repetitions]
+//        trace_replay --synthesize trace_file [operations]
+//
+// To record a trace, define C_STR_BUILDER_TRACE in all translation units of
+// the application, and run the workload between start() and stop() of a
+// c_str::trace_recorder, then save its records using c_str::write_trace().
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <random>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "../c_str_accounting_allocator.hpp"
+#include "../c_str_builder.hpp"
+#include "../c_str_large_page_allocator.hpp"
+#include "../c_str_memo_builder.hpp"
+#include "../c_str_padded_allocator.hpp"
+#include "../c_str_trace.hpp"
+#if __has_include(<sys/mman.h>)
+#  include "../c_str_shm_arena.hpp"
+#endif
+
+namespace
+{
+  // source objects of the recorded lengths, created before the replay is timed
+  template<class CharT>
+  struct sources
+  {
+    std::unordered_map<std::uint64_t, std::basic_string<CharT>> strings{};
+    std::unordered_map<std::uint64_t, std::deque<CharT>> deques{};
+
+    void add(const c_str::trace_record &record)
+    {
+      const auto [it, inserted]{ strings.try_emplace(record.length, static_cast<std::size_t>(record.length), static_cast<CharT>('a' + record.length % 26)) };
+      if (inserted || record.source == c_str::trace_source::segmented)
+        deques.try_emplace(record.length, it->second.begin(), it->second.end());
+    }
+  };
+
+  template<class BuilderT>
+  union slot
+  {
+    BuilderT builder;
+
+    slot() noexcept
+    {
+    }
+
+    ~slot()
+    {
+    }
+  };
+
+  template<class BuilderT>
+  class replayer
+  {
+    using char_type = typename BuilderT::value_type;
+
+    const sources<char_type> &_src;
+    std::vector<slot<BuilderT>> _slots;
+    std::vector<bool> _live;
+    std::size_t _sink{};
+
+    BuilderT &_at(const std::uint32_t idx)
+    {
+      if (!_live[idx]) // an object that existed before the recording started
+      {
+        std::construct_at(std::addressof(_slots[idx].builder));
+        _live[idx] = true;
+      }
+
+      return _slots[idx].builder;
+    }
+
+    template<class... ArgsT>
+    void _construct(const std::uint32_t idx, ArgsT &&...args)
+    {
+      if (_live[idx])
+        std::destroy_at(std::addressof(_slots[idx].builder));
+
+      std::construct_at(std::addressof(_slots[idx].builder), std::forward<ArgsT>(args)...);
+      _live[idx] = true;
+      _sink += static_cast<std::size_t>(_slots[idx].builder.view().size());
+    }
+
+    void _construct_from_source(const c_str::trace_record &record)
+    {
+      const auto &str{ _src.strings.at(record.length) };
+      switch (record.source)
+      {
+        case c_str::trace_source::null_pointer:
+          _construct(record.object, nullptr);
+          break;
+        case c_str::trace_source::pointer:
+          _construct(record.object, str.c_str());
+          break;
+        case c_str::trace_source::terminated:
+          _construct(record.object, str);
+          break;
+        case c_str::trace_source::null_terminated_range:
+          _construct(record.object, std::ranges::subrange{ str.c_str(), c_str::null_sentinel });
+          break;
+        case c_str::trace_source::segmented:
+          _construct(record.object, _src.deques.at(record.length));
+          break;
+        case c_str::trace_source::written:
+          _overwrite(record);
+          break;
+        default: // contiguous, the view includes the terminating null if it was found
+          _construct(record.object, std::basic_string_view<char_type>{ str.c_str(), str.size() + record.terminated });
+      }
+    }
+
+    void _overwrite(const c_str::trace_record &record)
+    {
+      const auto &str{ _src.strings.at(record.length) };
+      if constexpr (requires { BuilderT::for_overwrite(str.size(), [](char_type *) { return std::size_t{}; }); })
+        _construct(record.object, BuilderT::for_overwrite(str.size(), [&str](char_type *const buf) {
+                     std::char_traits<char_type>::copy(buf, str.data(), str.size());
+                     return str.size();
+                   }));
+      else
+        _construct(record.object, std::basic_string_view<char_type>{ str });
+    }
+
+  public:
+    replayer(const sources<char_type> &src, const std::uint32_t slotCount) :
+      _src{ src },
+      _slots(slotCount),
+      _live(slotCount)
+    {
+    }
+
+    replayer(const replayer &) = delete;
+    replayer &operator=(const replayer &) = delete;
+
+    ~replayer()
+    {
+      for (std::size_t idx{}; idx < _slots.size(); ++idx)
+        if (_live[idx])
+          std::destroy_at(std::addressof(_slots[idx].builder));
+    }
+
+    void apply(const c_str::trace_record &record)
+    {
+      switch (record.op)
+      {
+        case c_str::trace_op::construct:
+          _construct_from_source(record);
+          break;
+        case c_str::trace_op::copy_construct:
+          _construct(record.object, static_cast<const BuilderT &>(_at(record.other)));
+          break;
+        case c_str::trace_op::move_construct:
+          _construct(record.object, std::move(_at(record.other)));
+          break;
+        case c_str::trace_op::copy_assign:
+          _at(record.object) = static_cast<const BuilderT &>(_at(record.other));
+          break;
+        case c_str::trace_op::move_assign:
+          _at(record.object) = std::move(_at(record.other));
+          break;
+        case c_str::trace_op::swap:
+          _at(record.object).swap(_at(record.other));
+          break;
+        case c_str::trace_op::overwrite:
+          _overwrite(record);
+          break;
+        case c_str::trace_op::destroy:
+          if (_live[record.object])
+          {
+            std::destroy_at(std::addressof(_slots[record.object].builder));
+            _live[record.object] = false;
+          }
+      }
+    }
+
+    std::size_t sink() const noexcept
+    {
+      return _sink;
+    }
+  };
+
+  struct trace
+  {
+    std::vector<c_str::trace_record> records{};
+    std::uint32_t slot_count[5]{};
+    sources<char> narrow{};
+    sources<wchar_t> wide{};
+    sources<char16_t> u16{};
+    sources<char32_t> u32{};
+
+    explicit trace(std::vector<c_str::trace_record> &&recs) :
+      records{ std::move(recs) }
+    {
+      for (const auto &record : records)
+      {
+        if (record.char_size != 1 && record.char_size != 2 && record.char_size != 4)
+          continue;
+
+        if (record.object != c_str::trace_no_object && record.object >= slot_count[record.char_size])
+          slot_count[record.char_size] = record.object + 1;
+
+        if (record.other != c_str::trace_no_object && record.other >= slot_count[record.char_size])
+          slot_count[record.char_size] = record.other + 1;
+
+        if (record.op != c_str::trace_op::construct && record.op != c_str::trace_op::overwrite)
+          continue;
+
+        if (record.char_size == 1)
+          narrow.add(record);
+        else if (record.char_size == sizeof(wchar_t))
+          wide.add(record);
+        else if (record.char_size == 2)
+          u16.add(record);
+        else
+          u32.add(record);
+      }
+    }
+  };
+
+  // replays the trace using `Builder<char>`, `Builder<wchar_t>` etc. for the recorded character sizes
+  template<template<class> class Builder>
+  double replay(const trace &trc, const unsigned repetitions, std::size_t &sink)
+  {
+    const auto start{ std::chrono::steady_clock::now() };
+    for (unsigned rep{}; rep < repetitions; ++rep)
+    {
+      replayer<Builder<char>> narrow{ trc.narrow, trc.slot_count[1] };
+      replayer<Builder<wchar_t>> wide{ trc.wide, trc.slot_count[sizeof(wchar_t)] };
+      replayer<Builder<char16_t>> u16{ trc.u16, sizeof(wchar_t) == 2 ? 0 : trc.slot_count[2] };
+      replayer<Builder<char32_t>> u32{ trc.u32, sizeof(wchar_t) == 4 ? 0 : trc.slot_count[4] };
+      for (const auto &record : trc.records)
+      {
+        if (record.char_size == 1)
+          narrow.apply(record);
+        else if (record.char_size == sizeof(wchar_t))
+          wide.apply(record);
+        else if (record.char_size == 2)
+          u16.apply(record);
+        else if (record.char_size == 4)
+          u32.apply(record);
+      }
+
+      sink += narrow.sink() + wide.sink() + u16.sink() + u32.sink();
+    }
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  template<template<class> class Builder>
+  void report(const char *const name, const trace &trc, const unsigned repetitions)
+  {
+    std::size_t sink{};
+    const auto seconds{ replay<Builder>(trc, repetitions, sink) };
+    const auto ops{ static_cast<double>(trc.records.size()) * repetitions };
+    std::printf("%-16s | %9.2f Mop/s | %8.1f ns/op%s\n", name, ops / seconds / 1e6, seconds * 1e9 / ops, sink == 1 ? " " : "");
+  }
+
+  void summarize(const trace &trc)
+  {
+    static constexpr const char *opNames[]{ "construct", "copy_construct", "move_construct", "copy_assign", "move_assign", "swap", "overwrite", "destroy" };
+    static constexpr const char *sourceNames[]{ "null_pointer", "pointer", "terminated", "null_terminated_range", "contiguous", "segmented", "builder", "written" };
+    std::size_t opCounts[std::size(opNames)]{};
+    std::size_t sourceCounts[std::size(sourceNames)]{};
+    std::size_t copies{};
+    std::uint64_t copiedChars{};
+    std::unordered_map<std::uint64_t, std::uint64_t> constructed{}; // (character size, slot) => time of construction
+    double lifetimeSum{};
+    std::size_t lifetimes{};
+    for (const auto &record : trc.records)
+    {
+      const auto key{ (std::uint64_t{ record.char_size } << 32) | record.object };
+      ++opCounts[static_cast<std::size_t>(record.op) % std::size(opNames)];
+      if (record.op == c_str::trace_op::construct)
+      {
+        ++sourceCounts[static_cast<std::size_t>(record.source) % std::size(sourceNames)];
+        if (!record.terminated)
+        {
+          ++copies;
+          copiedChars += record.length;
+        }
+      }
+
+      if (record.op == c_str::trace_op::construct || record.op == c_str::trace_op::copy_construct || record.op == c_str::trace_op::move_construct)
+        constructed[key] = record.time_ns;
+      else if (record.op == c_str::trace_op::destroy)
+      {
+        const auto found{ constructed.find(key) };
+        if (found != constructed.end())
+        {
+          lifetimeSum += static_cast<double>(record.time_ns - found->second);
+          ++lifetimes;
+          constructed.erase(found);
+        }
+      }
+    }
+
+    std::printf("%zu records", trc.records.size());
+    for (std::size_t idx{}; idx < std::size(opNames); ++idx)
+      if (opCounts[idx])
+        std::printf(", %zu %s", opCounts[idx], opNames[idx]);
+
+    std::printf("\nconstructed from");
+    for (std::size_t idx{}; idx < std::size(sourceNames); ++idx)
+      if (sourceCounts[idx])
+        std::printf(" %s: %zu", sourceNames[idx], sourceCounts[idx]);
+
+    std::printf("\n%zu copies of %.1f characters on average, mean lifetime %.0f ns\n\n",
+                copies,
+                copies ? static_cast<double>(copiedChars) / static_cast<double>(copies) : 0.0,
+                lifetimes ? lifetimeSum / static_cast<double>(lifetimes) : 0.0);
+  }
+
+  // a workload of short-lived builders mostly constructed from unterminated views, some of which are kept and released later
+  std::vector<c_str::trace_record> synthesize(const std::size_t operations)
+  {
+    static constexpr std::uint32_t kept{ 64 };
+    static constexpr std::uint32_t tmp0{ kept }, tmp1{ kept + 1 };
+    std::vector<c_str::trace_record> records{};
+    std::mt19937_64 rng{ 42 };
+    std::geometric_distribution<std::uint64_t> lengthDist{ 1.0 / 40.0 };
+    std::uint64_t time{};
+    std::vector<bool> keptLive(kept);
+    const auto add{ [&](const c_str::trace_op op, const c_str::trace_source source, const std::uint32_t object, const std::uint32_t other, const std::uint64_t length, const bool terminated) {
+      c_str::trace_record record{};
+      record.time_ns = time += 20;
+      record.length = length;
+      record.object = object;
+      record.other = other;
+      record.op = op;
+      record.source = source;
+      record.char_size = 1;
+      record.terminated = terminated ? 1U : 0U;
+      records.push_back(record);
+    } };
+
+    while (records.size() < operations)
+    {
+      const auto length{ lengthDist(rng) };
+      const auto kind{ rng() % 10 };
+      const auto source{ kind < 6 ? c_str::trace_source::contiguous : kind < 8 ? c_str::trace_source::terminated : kind < 9 ? c_str::trace_source::pointer : c_str::trace_source::segmented };
+      const auto terminated{ source == c_str::trace_source::terminated || source == c_str::trace_source::pointer || (source == c_str::trace_source::contiguous && kind == 0) };
+      add(c_str::trace_op::construct, source, tmp0, c_str::trace_no_object, length, terminated);
+      if (rng() % 4 == 0)
+      {
+        add(c_str::trace_op::copy_construct, c_str::trace_source::builder, tmp1, tmp0, length, terminated);
+        add(c_str::trace_op::destroy, c_str::trace_source::builder, tmp1, c_str::trace_no_object, length, terminated);
+      }
+
+      if (rng() % 8 == 0)
+      {
+        const auto target{ static_cast<std::uint32_t>(rng() % kept) };
+        if (keptLive[target])
+          add(c_str::trace_op::move_assign, c_str::trace_source::builder, target, tmp0, length, terminated);
+        else
+        {
+          add(c_str::trace_op::move_construct, c_str::trace_source::builder, target, tmp0, length, terminated);
+          keptLive[target] = true;
+        }
+      }
+
+      add(c_str::trace_op::destroy, c_str::trace_source::builder, tmp0, c_str::trace_no_object, 0, true);
+    }
+
+    for (std::uint32_t idx{}; idx < kept; ++idx)
+      if (keptLive[idx])
+        add(c_str::trace_op::destroy, c_str::trace_source::builder, idx, c_str::trace_no_object, 0, true);
+
+    return records;
+  }
+
+  template<class CharT>
+  using std_builder = c_str::basic_builder<CharT>;
+
+  template<class CharT>
+  using keep_null_builder = c_str::basic_builder<CharT, c_str::if_null::keep_null_pointer>;
+
+  template<class CharT>
+  using large_page_builder = c_str::basic_large_builder<CharT>;
+
+  template<class CharT>
+  using padded_builder = c_str::basic_padded_builder<CharT>;
+
+  template<class CharT>
+  using accounted_builder = c_str::basic_accounted_builder<CharT>;
+
+  template<class CharT>
+  using memo_builder = c_str::basic_memo_builder<CharT>;
+
+#if __has_include(<sys/mman.h>)
+  template<class CharT>
+  using arena_builder = c_str::basic_arena_builder<CharT>;
+#endif
+} // namespace
+
+int main(int argc, char *argv[])
+{
+  try
+  {
+    if (argc > 2 && !std::strcmp(argv[1], "--synthesize"))
+    {
+      const auto records{ synthesize(argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1000000U) };
+      c_str::write_trace(argv[2], records);
+      std::printf("%zu records written to %s\n", records.size(), argv[2]);
+      return 0;
+    }
+
+    const trace trc{ argc > 1 ? c_str::read_trace(argv[1]) : synthesize(1000000U) };
+    const auto repetitions{ argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 5U };
+    summarize(trc);
+    report<std_builder>("std::allocator", trc, repetitions);
+    report<keep_null_builder>("keep_null", trc, repetitions);
+    report<large_page_builder>("large_page", trc, repetitions);
+    report<padded_builder>("padded", trc, repetitions);
+    report<accounted_builder>("accounted", trc, repetitions);
+    report<memo_builder>("memo", trc, repetitions);
+#if __has_include(<sys/mman.h>)
+    auto arena{ c_str::shm_arena::create(std::size_t{ 256 } << 20) };
+    arena.make_current();
+    report<arena_builder>("shm_arena", trc, repetitions);
+#endif
+  }
+  catch (const std::exception &e)
+  {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+}
@@ -0,0 +1,47 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str.cppm
+/// @brief     C++20 module interface unit of c_str_builder.hpp. It also
+///            provides the explicit instantiation definitions of the
+///            `c_str::basic_builder` type definitions.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C++20, including modules.
+
+module;
+
+// the headers included by c_str_builder.hpp belong to the global module fragment, under the same conditions (and default values of the configuration macros)
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#ifndef C_STR_BUILDER_SLIM
+#  include <algorithm>
+#  include <filesystem>
+#  include <ranges>
+#endif
+#if !defined(C_STR_LARGE_COPY_THRESHOLD) || C_STR_LARGE_COPY_THRESHOLD > 0
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#  endif
+#  if defined(__linux__)
+#    include <sys/mman.h>
+#  endif
+#  if defined(C_STR_LARGE_COPY_THREADS) && C_STR_LARGE_COPY_THREADS > 1
+#    include <thread>
+#  endif
+#endif
+
+export module c_str;
+
+#define C_STR_BUILDER_EXPORT export
+#define C_STR_BUILDER_INSTANTIATE_TEMPLATES
+#include "c_str_builder.hpp"
@@ -0,0 +1,268 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str_accounting_allocator.hpp
+/// @brief     Process-wide accounting and budget of the memory held by the
+///            owned buffers of `c_str::basic_builder` objects.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C++20.
+
+#ifndef C_STR_ACCOUNTING_ALLOCATOR_6CA5D223_9590_480B_974E_08593B81B2C0_1_0
+/// @cond _NO_DOC_
+#define C_STR_ACCOUNTING_ALLOCATOR_6CA5D223_9590_480B_974E_08593B81B2C0_1_0
+/// @endcond
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include "c_str_builder.hpp"
+
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wc++98-compat" // C++20 is required anyway
+#elif defined(_MSC_VER)
+#  pragma warning(push)
+#  pragma warning(disable : 4710 4711) // functions may or may not be inlined
+#endif
+
+namespace c_str
+{
+
+  /// @brief Exception thrown if allocating an owned buffer would exceed the
+  ///        hard limit of the memory budget. See `c_str::memory_account`.
+  class budget_exceeded : public std::bad_alloc
+  {
+  public:
+    /// @brief Provides the explanatory string.
+    const char *what() const noexcept override
+    {
+      return "c_str: the hard limit of the memory budget for owned string buffers would be exceeded";
+    }
+  };
+
+  /// @brief The `c_str::memory_account` class template tracks the live bytes
+  ///        of the owned buffers allocated by `c_str::accounting_allocator`
+  ///        for character type `CharT`, and enforces a budget.
+  ///
+  /// Exceeding the soft limit calls the soft limit handler, once per
+  /// crossing. An allocation that would exceed the hard limit fails with a
+  /// `c_str::budget_exceeded` exception, i.e. the construction of the
+  /// `c_str::basic_builder` object fails instead of the heap growing. Both
+  /// limits are unlimited by default. <br>
+  /// All member functions are static and thread-safe. The limits are checked
+  /// without locking, so concurrent allocations may overshoot the soft limit
+  /// by less than their sizes before the handler is called.
+  /// @tparam CharT  Value type of the characters.
+  template<common_char_type CharT>
+  class memory_account
+  {
+  public:
+    /// @brief Type of the handler called when the soft limit is exceeded. It
+    ///        receives the live bytes and the soft limit. It must not throw.
+    using soft_limit_handler = void (*)(std::size_t liveBytes, std::size_t softLimit) noexcept;
+
+    /// @brief Value of a limit that is not set.
+    static constexpr std::size_t unlimited{ (std::numeric_limits<std::size_t>::max)() };
+
+  private:
+    inline static std::atomic<std::size_t> _m_live{};
+    inline static std::atomic<std::size_t> _m_peak{};
+    inline static std::atomic<std::size_t> _m_buffers{};
+    inline static std::atomic<std::size_t> _m_soft_limit{ unlimited };
+    inline static std::atomic<std::size_t> _m_hard_limit{ unlimited };
+    inline static std::atomic<soft_limit_handler> _m_handler{};
+
+  public:
+    memory_account() = delete;
+
+    /// @brief Number of bytes of the live owned buffers.
+    static std::size_t live_bytes() noexcept
+    {
+      return _m_live.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Highest number of live bytes observed.
+    static std::size_t peak_bytes() noexcept
+    {
+      return _m_peak.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Number of live owned buffers.
+    static std::size_t live_buffers() noexcept
+    {
+      return _m_buffers.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Set the soft limit and the handler called if it gets exceeded.
+    /// @param bytes    Soft limit in bytes, or `unlimited`.
+    /// @param handler  Handler to be called, or a null pointer.
+    static void set_soft_limit(const std::size_t bytes, const soft_limit_handler handler = nullptr) noexcept
+    {
+      _m_handler.store(handler, std::memory_order_relaxed);
+      _m_soft_limit.store(bytes, std::memory_order_relaxed);
+    }
+
+    /// @brief Set the hard limit.
+    /// @param bytes  Hard limit in bytes, or `unlimited`.
+    static void set_hard_limit(const std::size_t bytes) noexcept
+    {
+      _m_hard_limit.store(bytes, std::memory_order_relaxed);
+    }
+
+    /// @brief Current soft limit in bytes.
+    static std::size_t soft_limit() noexcept
+    {
+      return _m_soft_limit.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Current hard limit in bytes.
+    static std::size_t hard_limit() noexcept
+    {
+      return _m_hard_limit.load(std::memory_order_relaxed);
+    }
+
+    /// @cond _NO_DOC_
+    static void _charge(const std::size_t bytes)
+    {
+      const auto hardLimit{ _m_hard_limit.load(std::memory_order_relaxed) };
+      auto live{ _m_live.load(std::memory_order_relaxed) };
+      do
+      {
+        if (bytes > hardLimit || live > hardLimit - bytes)
+          throw budget_exceeded{};
+      } while (!_m_live.compare_exchange_weak(live, live + bytes, std::memory_order_relaxed));
+
+      const auto newLive{ live + bytes };
+      _m_buffers.fetch_add(1, std::memory_order_relaxed);
+      for (auto peak{ _m_peak.load(std::memory_order_relaxed) }; peak < newLive && !_m_peak.compare_exchange_weak(peak, newLive, std::memory_order_relaxed);)
+      {
+      }
+
+      if (const auto softLimit{ _m_soft_limit.load(std::memory_order_relaxed) }; live <= softLimit && newLive > softLimit)
+        if (const auto handler{ _m_handler.load(std::memory_order_relaxed) }; handler)
+          handler(newLive, softLimit);
+    }
+
+    static void _discharge(const std::size_t bytes) noexcept
+    {
+      _m_live.fetch_sub(bytes, std::memory_order_relaxed);
+      _m_buffers.fetch_sub(1, std::memory_order_relaxed);
+    }
+    /// @endcond
+  };
+
+  /// @brief The `c_str::accounting_allocator` class template is an allocator
+  ///        that charges the allocated bytes to `c_str::memory_account<T>`
+  ///        and forwards the allocation to `BaseAllocT`.
+  ///
+  /// The allocator derives from `BaseAllocT`, so traits of the base allocator
+  /// like the `padding` constant of `c_str::padded_allocator` remain in
+  /// effect.
+  /// @tparam T           Value type of the allocated elements.
+  /// @tparam BaseAllocT  Allocator performing the allocations.
+  template<class T, class BaseAllocT = std::allocator<T>>
+  class accounting_allocator : public BaseAllocT
+  {
+    using _base_traits = std::allocator_traits<BaseAllocT>;
+
+  public:
+    /// @brief Type of the allocated elements.
+    using value_type = T;
+
+    /// @brief Type of the number of allocated elements.
+    using size_type = std::size_t;
+
+    /// @brief Rebinds the allocator to another value type.
+    template<class U>
+    struct rebind
+    {
+      /// @brief Allocator type for elements of type `U`.
+      using other = accounting_allocator<U, typename _base_traits::template rebind_alloc<U>>;
+    };
+
+    /// @brief Default constructor.
+    constexpr accounting_allocator() noexcept(std::is_nothrow_default_constructible_v<BaseAllocT>) = default;
+
+    /// @brief Construct from a base allocator.
+    constexpr accounting_allocator(const BaseAllocT &base) noexcept :
+      BaseAllocT{ base }
+    {
+    }
+
+    /// @brief Converting constructor for a rebound allocator.
+    template<class U, class OtherBaseAllocT>
+    constexpr accounting_allocator(const accounting_allocator<U, OtherBaseAllocT> &other) noexcept :
+      BaseAllocT{ static_cast<const OtherBaseAllocT &>(other) }
+    {
+    }
+
+    /// @brief Allocate a buffer for `count` elements.
+    /// @param count  Number of elements.
+    /// @return Pointer to the first element of the uninitialized buffer.
+    [[nodiscard]] constexpr value_type *allocate(const size_type count)
+    {
+      if (std::is_constant_evaluated())
+        return _base_traits::allocate(*this, count);
+
+      if constexpr (common_char_type<value_type>)
+      {
+        if (count > (std::numeric_limits<size_type>::max)() / sizeof(value_type))
+          throw std::bad_array_new_length{};
+
+        memory_account<value_type>::_charge(count * sizeof(value_type));
+        try
+        {
+          return _base_traits::allocate(*this, count);
+        }
+        catch (...)
+        {
+          memory_account<value_type>::_discharge(count * sizeof(value_type));
+          throw;
+        }
+      }
+      else
+        return _base_traits::allocate(*this, count);
+    }
+
+    /// @brief Release a buffer obtained from `allocate()`.
+    /// @param buf    Pointer returned by `allocate()`.
+    /// @param count  Number of elements passed to `allocate()`.
+    constexpr void deallocate(value_type *const buf, const size_type count) noexcept
+    {
+      if constexpr (common_char_type<value_type>)
+        if (!std::is_constant_evaluated())
+          memory_account<value_type>::_discharge(count * sizeof(value_type));
+
+      _base_traits::deallocate(*this, buf, count);
+    }
+
+    /// @brief Compares the base allocators.
+    friend constexpr bool operator==(const accounting_allocator &lhs, const accounting_allocator &rhs) noexcept
+    {
+      return static_cast<const BaseAllocT &>(lhs) == static_cast<const BaseAllocT &>(rhs);
+    }
+  };
+
+  /// @brief `c_str::basic_accounted_builder` is a `c_str::basic_builder` whose
+  ///        owned buffers are charged to `c_str::memory_account<CharT>`.
+  template<common_char_type CharT, if_null NullBehavior = if_null::DEF_NULL_BEHAVIOR, class BaseAllocT = std::allocator<CharT>>
+  using basic_accounted_builder = basic_builder<CharT, NullBehavior, accounting_allocator<CharT, BaseAllocT>>;
+
+  /// @brief `c_str::accounted_builder` is a type definition for
+  ///        `c_str::basic_accounted_builder<char>`.
+  typedef basic_accounted_builder<char> accounted_builder;
+
+} // namespace c_str
+
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#elif defined(_MSC_VER)
+#  pragma warning(pop)
+#endif
+
+#endif // include guard
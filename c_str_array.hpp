@@ -0,0 +1,517 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str_array.hpp
+/// @brief     Bulk conversion of collections of string-like objects and of
+///            columnar string buffers into arrays of C-strings.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C++20.
+
+#ifndef C_STR_ARRAY_98312E35_19C8_4D1A_BC60_5F1420B1C3FA_1_0
+/// @cond _NO_DOC_
+#define C_STR_ARRAY_98312E35_19C8_4D1A_BC60_5F1420B1C3FA_1_0
+/// @endcond
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "c_str_builder.hpp"
+
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wc++98-compat" // C++20 is required anyway
+#elif defined(_MSC_VER)
+#  pragma warning(push)
+#  pragma warning(disable : 4710 4711) // functions may or may not be inlined
+#endif
+
+namespace c_str
+{
+
+  /// @brief Concept to ensure `ElemT` can be converted into a C-string of
+  ///        `CharT` elements by a `c_str::basic_builder`.
+  template<class ElemT, class CharT>
+  concept string_element_of_type = std::is_null_pointer_v<ElemT> || string_like_of_type<ElemT, CharT>;
+
+  /// @brief Concept to ensure `OffsetsT` is a contiguous sequence of integral
+  ///        offsets, like the offsets buffer of an Apache Arrow string column.
+  template<class OffsetsT>
+  concept column_offsets = std::ranges::contiguous_range<OffsetsT> && std::ranges::sized_range<OffsetsT> && std::integral<std::ranges::range_value_t<OffsetsT>>;
+
+  /// @brief The `c_str::basic_c_str_array` class template converts a whole
+  ///        collection of string-like objects into an array of pointers to
+  ///        C-strings, like C bulk interfaces expect (`const char **`).
+  ///
+  /// The conversion of every element follows the rules of
+  /// `c_str::basic_builder`. Elements that are already null-terminated are
+  /// referenced without copying. All other elements are copied into a single
+  /// blob of null-terminated strings. The pointer array (followed by a null
+  /// pointer, like `argv`) and the blob share one allocation. <br>
+  /// The overload taking an execution policy determines the offsets of the
+  /// copies in the blob using a parallel prefix sum, and copies the elements
+  /// in parallel. This pays off for millions of strings. <br>
+  /// Like the pointers provided by a `c_str::basic_builder`, the pointers to
+  /// referenced elements are only valid as long as the elements exist and are
+  /// not modified. Objects are movable, but not copyable.
+  ///
+  /// @tparam CharT         Value type of the characters.
+  /// @tparam NullBehavior  Value of the `c_str::if_null` enumeration. See
+  ///                       @ref NullBehavior.
+  /// @tparam AllocatorT    Allocator type, rebound to allocate the shared
+  ///                       buffer of the pointer array and the blob.
+  template<common_char_type CharT, if_null NullBehavior = if_null::DEF_NULL_BEHAVIOR, class AllocatorT = std::allocator<CharT>>
+  class basic_c_str_array
+  {
+  public:
+    /// @brief Character type of the `CharT` template parameter.
+    using value_type = CharT;
+
+    /// @brief Type of the provided pointers to the C-strings.
+    using const_pointer = const value_type *;
+
+    /// @brief Type of sizes and indexes.
+    using size_type = std::size_t;
+
+    /// @brief Type of the iterators over the C-string pointers.
+    using const_iterator = const const_pointer *;
+
+    /// @brief Value of the `NullBehavior` template parameter.
+    static constexpr if_null null_behavior{ NullBehavior };
+
+  private:
+    using _traits_type = std::char_traits<value_type>;
+    using _allocator_type = typename std::allocator_traits<AllocatorT>::template rebind_alloc<const_pointer>;
+    using _alloc_traits = std::allocator_traits<_allocator_type>;
+
+    static constexpr value_type _m_zero{};
+
+    [[no_unique_address]] _allocator_type _m_alloc{};
+    const_pointer *_m_ptrs{}; // `_m_count + 1` pointers, followed by the blob
+    size_type _m_count{};
+    size_type _m_slots{}; // number of allocated pointer-sized slots
+
+    static constexpr const_pointer _null_ptr() noexcept
+    {
+      if constexpr (null_behavior == if_null::make_zero_length)
+        return std::addressof(_m_zero);
+      else
+        return nullptr;
+    }
+
+    // number of characters to be copied into the blob for the element, including the terminating null; 0 if it is referenced
+    template<class ElemT>
+    static constexpr size_type _copy_size(const ElemT &elem) noexcept
+    {
+      if constexpr (std::is_null_pointer_v<ElemT> || std::is_pointer_v<ElemT> || terminated_string_like_of_type<ElemT, value_type> || null_terminated_range_of_type<ElemT, value_type>)
+        return 0;
+      else if constexpr (segmented_string_like_of_type<ElemT, value_type>)
+        return static_cast<size_type>(std::ranges::distance(elem)) + 1;
+      else
+      {
+        const auto size{ static_cast<size_type>(std::ranges::size(elem)) };
+        return size && std::ranges::cdata(elem)[size - 1] ? size + 1 : 0; // the same condition as copying in `c_str::basic_builder`
+      }
+    }
+
+    // provides the C-string of the element, copied to `dest` if `_copy_size()` is not 0
+    template<class ElemT>
+    static constexpr const_pointer _place(const ElemT &elem, value_type *const dest) noexcept
+    {
+      if constexpr (std::is_null_pointer_v<ElemT>)
+        return _null_ptr();
+      else if constexpr (std::is_pointer_v<ElemT>)
+        return !elem ? _null_ptr() : elem;
+      else if constexpr (terminated_string_like_of_type<ElemT, value_type>)
+        return elem.c_str();
+      else if constexpr (null_terminated_range_of_type<ElemT, value_type>)
+        return _place(static_cast<const_pointer>(elem.begin()), dest);
+      else if constexpr (segmented_string_like_of_type<ElemT, value_type>)
+      {
+        *std::ranges::copy(elem, dest).out = value_type{};
+        return dest;
+      }
+      else
+      {
+        const auto size{ static_cast<size_type>(std::ranges::size(elem)) };
+        if (!size)
+          return std::addressof(_m_zero);
+
+        const auto data{ std::ranges::cdata(elem) };
+        if (!data[size - 1])
+          return data;
+
+        _traits_type::copy(dest, data, size);
+        dest[size] = value_type{};
+        return dest;
+      }
+    }
+
+    void _allocate(const size_type count, const size_type blobSize)
+    {
+      _m_count = count;
+      _m_slots = count + 1 + (blobSize * sizeof(value_type) + sizeof(const_pointer) - 1) / sizeof(const_pointer);
+      _m_ptrs = _alloc_traits::allocate(_m_alloc, _m_slots);
+      _m_ptrs[count] = nullptr;
+    }
+
+    value_type *_blob() const noexcept
+    {
+      return reinterpret_cast<value_type *>(_m_ptrs + _m_count + 1);
+    }
+
+    void _release() noexcept
+    {
+      if (_m_ptrs)
+        _alloc_traits::deallocate(_m_alloc, _m_ptrs, _m_slots);
+
+      _m_ptrs = nullptr;
+      _m_count = _m_slots = 0;
+    }
+
+  public:
+    /// @brief Default constructor that creates an empty array.
+    basic_c_str_array() noexcept = default;
+
+    /// @brief Convert the values of a columnar string buffer, consisting of
+    ///        an offsets buffer and a data buffer (like an Apache Arrow string
+    ///        column).
+    ///
+    /// Value `i` is the sequence in range [`offsets[i]`, `offsets[i + 1]`) of
+    /// `data`. Thus, `offsets` has one element more than the number of
+    /// values. Like in `c_str::basic_builder`, a value whose last character
+    /// is a null is referenced, all other values are copied into the blob.
+    /// The values of a `c_str::basic_terminated_column` are referenced
+    /// without any copy.
+    /// @pre The offsets are non-negative, non-decreasing, and not greater than
+    ///      the size of `data`.
+    /// @tparam OffsetsT  Type of the offsets buffer.
+    /// @param offsets  Offsets of the values in `data`.
+    /// @param data     Character data of the values.
+    /// @return Array of the converted values.
+    template<column_offsets OffsetsT>
+    static basic_c_str_array from_columns(const OffsetsT &offsets, const std::span<const value_type> data)
+    {
+      basic_c_str_array array{};
+      const auto offsetData{ std::ranges::cdata(offsets) };
+      const auto count{ std::ranges::empty(offsets) ? size_type{} : static_cast<size_type>(std::ranges::size(offsets)) - 1 };
+      size_type blobSize{};
+      for (size_type idx{}; idx < count; ++idx) // touches only the last character of every value
+        if (const auto end{ static_cast<size_type>(offsetData[idx + 1]) }; end != static_cast<size_type>(offsetData[idx]) && data[end - 1])
+          blobSize += end - static_cast<size_type>(offsetData[idx]) + 1;
+
+      array._allocate(count, blobSize);
+      auto dest{ array._blob() };
+      for (size_type idx{}; idx < count; ++idx)
+      {
+        const auto begin{ static_cast<size_type>(offsetData[idx]) };
+        const auto size{ static_cast<size_type>(offsetData[idx + 1]) - begin };
+        array._m_ptrs[idx] = _place(data.subspan(begin, size), dest);
+        if (size && data[begin + size - 1])
+          dest += size + 1;
+      }
+
+      return array;
+    }
+
+    /// @brief Convert the elements of a collection.
+    /// @tparam RangeT  Type of the collection, a forward range of string-like
+    ///                 objects or pointers to `CharT`.
+    /// @param range  Collection of string-like objects.
+    template<std::ranges::forward_range RangeT>
+    explicit basic_c_str_array(const RangeT &range)
+      requires string_element_of_type<std::ranges::range_value_t<RangeT>, value_type>
+    {
+      size_type blobSize{};
+      for (const auto &elem : range)
+        blobSize += _copy_size(elem);
+
+      _allocate(static_cast<size_type>(std::ranges::distance(range)), blobSize);
+      auto dest{ _blob() };
+      auto ptr{ _m_ptrs };
+      for (const auto &elem : range)
+      {
+        const auto copySize{ _copy_size(elem) };
+        *ptr++ = _place(elem, dest);
+        dest += copySize;
+      }
+    }
+
+    /// @brief Convert the elements of a collection using an execution policy.
+    /// @tparam ExecPolicyT  Type of the execution policy, like
+    ///                      `std::execution::parallel_policy`.
+    /// @tparam RangeT       Type of the collection, a random access range of
+    ///                      string-like objects or pointers to `CharT`.
+    /// @param policy  Execution policy, like `std::execution::par`.
+    /// @param range   Collection of string-like objects.
+    template<class ExecPolicyT, std::ranges::random_access_range RangeT>
+    basic_c_str_array(ExecPolicyT &&policy, const RangeT &range)
+      requires std::is_execution_policy_v<std::remove_cvref_t<ExecPolicyT>> && std::ranges::sized_range<RangeT> &&
+               string_element_of_type<std::ranges::range_value_t<RangeT>, value_type>
+    {
+      static_assert(sizeof(size_type) <= sizeof(const_pointer) && alignof(size_type) <= alignof(const_pointer), "the offsets are computed in the pointer slots");
+      const auto count{ static_cast<size_type>(std::ranges::size(range)) };
+      const auto first{ std::ranges::begin(range) };
+      const auto last{ first + static_cast<std::ranges::range_difference_t<RangeT>>(count) };
+      const auto copySize{ [](const auto &elem) noexcept {
+        return _copy_size(elem);
+      } };
+      _allocate(count, std::transform_reduce(policy, first, last, size_type{}, std::plus<>{}, copySize));
+
+      // the prefix sum of the copy sizes is computed in place, every pointer slot holds the offset of its copy until it is replaced by the pointer
+      const auto offsets{ reinterpret_cast<size_type *>(_m_ptrs) };
+      std::transform_exclusive_scan(policy, first, last, offsets, size_type{}, std::plus<>{}, copySize);
+      const auto blob{ _blob() };
+      const auto ptrs{ _m_ptrs };
+      std::for_each(std::forward<ExecPolicyT>(policy), offsets, offsets + count, [&](size_type &offset) noexcept {
+        const auto idx{ static_cast<size_type>(std::addressof(offset) - offsets) };
+        const auto dest{ blob + offset }; // read before the slot is overwritten
+        ptrs[idx] = _place(first[static_cast<std::ranges::range_difference_t<RangeT>>(idx)], dest);
+      });
+    }
+
+    basic_c_str_array(const basic_c_str_array &) = delete;
+    basic_c_str_array &operator=(const basic_c_str_array &) = delete;
+
+    /// @brief Move constructor.
+    basic_c_str_array(basic_c_str_array &&other) noexcept :
+      _m_alloc{ other._m_alloc },
+      _m_ptrs{ std::exchange(other._m_ptrs, nullptr) },
+      _m_count{ std::exchange(other._m_count, 0) },
+      _m_slots{ std::exchange(other._m_slots, 0) }
+    {
+    }
+
+    /// @brief Move assignment operator.
+    basic_c_str_array &operator=(basic_c_str_array &&other) noexcept
+    {
+      swap(other);
+      return *this;
+    }
+
+    /// @brief Destructor releasing the shared buffer.
+    ~basic_c_str_array()
+    {
+      _release();
+    }
+
+    /// @brief Provides the array of C-string pointers, followed by a null
+    ///        pointer. If the array is empty, the pointer may be null.
+    const_pointer *data() noexcept
+    {
+      return _m_ptrs;
+    }
+
+    /// @brief Provides the array of C-string pointers, followed by a null
+    ///        pointer. If the array is empty, the pointer may be null.
+    const const_pointer *data() const noexcept
+    {
+      return _m_ptrs;
+    }
+
+    /// @brief Number of C-strings.
+    size_type size() const noexcept
+    {
+      return _m_count;
+    }
+
+    /// @brief Check whether the array is empty.
+    bool empty() const noexcept
+    {
+      return !_m_count;
+    }
+
+    /// @brief Provides the C-string at index `idx`.
+    const_pointer operator[](const size_type idx) const noexcept
+    {
+      return _m_ptrs[idx];
+    }
+
+    /// @brief Iterator to the first C-string pointer.
+    const_iterator begin() const noexcept
+    {
+      return _m_ptrs;
+    }
+
+    /// @brief Iterator behind the last C-string pointer.
+    const_iterator end() const noexcept
+    {
+      return _m_ptrs + _m_count;
+    }
+
+    /// @brief Number of bytes held by the shared buffer of the pointer array
+    ///        and the blob.
+    size_type owned_bytes() const noexcept
+    {
+      return _m_slots * sizeof(const_pointer);
+    }
+
+    /// @brief Exchanges the contents of this object with those of `other`.
+    void swap(basic_c_str_array &other) noexcept
+    {
+      using std::swap;
+      if constexpr (_alloc_traits::propagate_on_container_swap::value)
+        swap(_m_alloc, other._m_alloc);
+
+      swap(_m_ptrs, other._m_ptrs);
+      swap(_m_count, other._m_count);
+      swap(_m_slots, other._m_slots);
+    }
+  };
+
+  /// @brief The `c_str::basic_terminated_column` class template is a columnar
+  ///        string buffer whose values are null-terminated.
+  ///
+  /// It is created once from an unterminated columnar buffer (like an Apache
+  /// Arrow string column) by copying the data and inserting a terminating
+  /// null behind every value. The offsets are widened accordingly: value `i`
+  /// including its terminating null is the sequence in range
+  /// [`offsets()[i]`, `offsets()[i + 1]`) of `data()`. <br>
+  /// Afterwards, every value is available as C-string without any further
+  /// copy, e.g. for C libraries of user-defined functions that are called
+  /// many times for the same column. `c_str::basic_c_str_array::from_columns()`
+  /// references all values of the column.
+  ///
+  /// @tparam CharT    Value type of the characters.
+  /// @tparam OffsetT  Integral type of the widened offsets.
+  template<common_char_type CharT, std::integral OffsetT = std::int64_t>
+  class basic_terminated_column
+  {
+  public:
+    /// @brief Character type of the `CharT` template parameter.
+    using value_type = CharT;
+
+    /// @brief Type of the widened offsets.
+    using offset_type = OffsetT;
+
+    /// @brief Type of sizes and indexes.
+    using size_type = std::size_t;
+
+  private:
+    std::vector<offset_type> _m_offsets{};
+    std::unique_ptr<value_type[]> _m_data{};
+    size_type _m_data_size{};
+
+  public:
+    /// @brief Default constructor that creates an empty column.
+    basic_terminated_column() noexcept = default;
+
+    /// @brief Create the terminated layout of a columnar string buffer.
+    /// @pre The offsets are non-negative, non-decreasing, and not greater than
+    ///      the size of `data`.
+    /// @tparam OffsetsT  Type of the offsets buffer.
+    /// @param offsets  Offsets of the values in `data`, one element more than
+    ///                 the number of values.
+    /// @param data     Character data of the values.
+    /// @throw std::length_error if the widened offsets exceed the range of
+    ///        `offset_type`.
+    template<column_offsets OffsetsT>
+    basic_terminated_column(const OffsetsT &offsets, const std::span<const value_type> data)
+    {
+      if (std::ranges::empty(offsets))
+        return;
+
+      const auto offsetData{ std::ranges::cdata(offsets) };
+      const auto count{ static_cast<size_type>(std::ranges::size(offsets)) - 1 };
+      const auto first{ static_cast<size_type>(offsetData[0]) };
+      _m_data_size = static_cast<size_type>(offsetData[count]) - first + count;
+      if (_m_data_size > static_cast<size_type>((std::numeric_limits<offset_type>::max)()))
+        throw std::length_error{ "c_str::basic_terminated_column: the widened offsets exceed the range of the offset type" };
+
+      _m_offsets.resize(count + 1);
+      _m_data = std::make_unique_for_overwrite<value_type[]>(_m_data_size);
+      auto dest{ _m_data.get() };
+      for (size_type idx{}; idx < count; ++idx)
+      {
+        const auto begin{ static_cast<size_type>(offsetData[idx]) };
+        const auto size{ static_cast<size_type>(offsetData[idx + 1]) - begin };
+        _m_offsets[idx] = static_cast<offset_type>(dest - _m_data.get());
+        std::char_traits<value_type>::copy(dest, data.data() + begin, size);
+        dest[size] = value_type{};
+        dest += size + 1;
+      }
+
+      _m_offsets[count] = static_cast<offset_type>(_m_data_size);
+    }
+
+    /// @brief Number of values.
+    size_type size() const noexcept
+    {
+      return _m_offsets.empty() ? size_type{} : _m_offsets.size() - 1;
+    }
+
+    /// @brief Provides value `idx` as C-string.
+    const value_type *c_str(const size_type idx) const noexcept
+    {
+      return _m_data.get() + _m_offsets[idx];
+    }
+
+    /// @brief Provides the length of value `idx`, without the terminating
+    ///        null.
+    size_type length(const size_type idx) const noexcept
+    {
+      return static_cast<size_type>(_m_offsets[idx + 1] - _m_offsets[idx]) - 1;
+    }
+
+    /// @brief Provides value `idx` as string view.
+    std::basic_string_view<value_type> view(const size_type idx) const noexcept
+    {
+      return { c_str(idx), length(idx) };
+    }
+
+    /// @brief Provides the widened offsets.
+    std::span<const offset_type> offsets() const noexcept
+    {
+      return _m_offsets;
+    }
+
+    /// @brief Provides the character data, including the terminating nulls.
+    std::span<const value_type> data() const noexcept
+    {
+      return { _m_data.get(), _m_data_size };
+    }
+
+    /// @brief Number of bytes held by the offsets and the character data.
+    size_type owned_bytes() const noexcept
+    {
+      return _m_offsets.capacity() * sizeof(offset_type) + _m_data_size * sizeof(value_type);
+    }
+  };
+
+  /// @brief `c_str::terminated_column` is a type definition for
+  ///        `c_str::basic_terminated_column<char>`.
+  typedef basic_terminated_column<char> terminated_column;
+
+  /// @brief `c_str::c_str_array` is a type definition for
+  ///        `c_str::basic_c_str_array<char>`.
+  typedef basic_c_str_array<char> c_str_array;
+
+  /// @brief `c_str::wc_str_array` is a type definition for
+  ///        `c_str::basic_c_str_array<wchar_t>`.
+  typedef basic_c_str_array<wchar_t> wc_str_array;
+
+} // namespace c_str
+
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#elif defined(_MSC_VER)
+#  pragma warning(pop)
+#endif
+
+#endif // include guard
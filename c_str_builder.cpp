@@ -0,0 +1,14 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str_builder.cpp
+/// @brief     Explicit instantiation definitions of the `c_str::basic_builder`
+///            type definitions for header mode. It must be linked if
+///            `C_STR_BUILDER_EXTERN_TEMPLATES` is defined.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C++20.
+
+#define C_STR_BUILDER_INSTANTIATE_TEMPLATES
+#include "c_str_builder.hpp"
@@ -13,14 +13,56 @@
 #define C_STR_BUILDER_5520EC13_98D8_4C64_A4E6_B2F03589532A_1_0
 /// @endcond
 
+#include <atomic>
 #include <concepts>
 #include <cstddef>
-#include <filesystem>
+#include <cstdint>
+#include <cstring>
 #include <memory>
-#include <ranges>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
+#ifndef C_STR_BUILDER_SLIM
+#  include <algorithm>
+#  include <filesystem>
+#  include <ranges>
+#endif
+
+#ifndef C_STR_LARGE_COPY_THRESHOLD
+/// @brief Size in bytes from which on a string is copied into the owned buffer
+///        using the large-copy tier. See @ref LargeCopy for more information.
+#  define C_STR_LARGE_COPY_THRESHOLD 1048576
+#endif
+
+#ifndef C_STR_LARGE_COPY_THREADS
+/// @brief Number of threads used to copy a string of at least
+///        `C_STR_PARALLEL_COPY_THRESHOLD` bytes into the owned buffer. The
+///        default value 1 disables the multi-threaded copy.
+#  define C_STR_LARGE_COPY_THREADS 1
+#endif
+
+#ifndef C_STR_PARALLEL_COPY_THRESHOLD
+/// @brief Size in bytes from which on a string is copied into the owned buffer
+///        using `C_STR_LARGE_COPY_THREADS` threads.
+#  define C_STR_PARALLEL_COPY_THRESHOLD 33554432
+#endif
+
+
+#if C_STR_LARGE_COPY_THRESHOLD > 0
+#  if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+/// @cond _NO_DOC_
+#    define C_STR_STREAMING_STORES_
+/// @endcond
+#  endif
+#  if defined(__linux__)
+#    include <sys/mman.h>
+#  endif
+#  if C_STR_LARGE_COPY_THREADS > 1
+#    include <thread>
+#  endif
+#endif
 
 #if defined(__clang__)
 #  pragma clang diagnostic push
@@ -36,8 +78,38 @@
 #  define DEF_NULL_BEHAVIOR make_zero_length
 #endif
 
+#if defined(_MSC_VER) && !defined(__clang__)
+/// @cond _NO_DOC_
+#  define C_STR_NO_UNIQUE_ADDRESS_ [[msvc::no_unique_address]]
+/// @endcond
+#else
+/// @cond _NO_DOC_
+#  define C_STR_NO_UNIQUE_ADDRESS_ [[no_unique_address]]
+/// @endcond
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+/// @cond _NO_DOC_
+#  define C_STR_COLD_ [[gnu::noinline, gnu::cold]]
+/// @endcond
+#elif defined(_MSC_VER)
+/// @cond _NO_DOC_
+#  define C_STR_COLD_ __declspec(noinline)
+/// @endcond
+#else
+/// @cond _NO_DOC_
+#  define C_STR_COLD_
+/// @endcond
+#endif
+
+#ifndef C_STR_BUILDER_EXPORT
+/// @cond _NO_DOC_
+#  define C_STR_BUILDER_EXPORT // defined as `export` in the c_str.cppm module interface unit
+/// @endcond
+#endif
+
 /// @brief Namespace for the `c_str::basic_builder` class and related code.
-namespace c_str
+C_STR_BUILDER_EXPORT namespace c_str
 {
 
   /// @brief Concept to ensure that only buffers based on character types
@@ -52,36 +124,104 @@ namespace c_str
     std::same_as<CharT, char16_t> ||
     std::same_as<CharT, char32_t>;
 
+  /// @brief Sentinel type denoting the end of a null-terminated sequence of
+  ///        characters.
+  ///
+  /// A pointer to a C-string paired with a `c_str::null_sentinel_t` (e.g. in a
+  /// `std::ranges::subrange<const char *, c_str::null_sentinel_t>`) is a range
+  /// of the characters that doesn't need the string length to be determined
+  /// in advance. Range algorithms iterating it stop at the terminating null.
+  struct null_sentinel_t
+  {
+    /// @brief Checks whether `it` points to the terminating null.
+    template<common_char_type CharT>
+    friend constexpr bool operator==(const CharT *const it, null_sentinel_t) noexcept
+    {
+      return *it == CharT{};
+    }
+  };
+
+  /// @brief Value of the `c_str::null_sentinel_t` type.
+  inline constexpr null_sentinel_t null_sentinel{};
+
+  /// @brief Concept to ensure `StrLikeT` is a null-terminated sequence of
+  ///        `CharT` elements modeled by a pointer and a
+  ///        `c_str::null_sentinel_t` (like a `std::ranges::subrange` of them, or
+  ///        a `c_str::basic_builder`).
+  template<class StrLikeT, class CharT>
+  concept null_terminated_range_of_type = requires(const StrLikeT &strLike) {
+    { strLike.begin() } -> std::convertible_to<const CharT *>;
+    { strLike.end() } -> std::same_as<null_sentinel_t>;
+  };
+
+  /// @brief Concept to ensure `StrLikeT` provides a null-terminated sequence
+  ///        of `CharT` elements via its `c_str()` member function (like
+  ///        `std::basic_string` and `std::filesystem::path`).
+  template<class StrLikeT, class CharT>
+  concept terminated_string_like_of_type = requires(const StrLikeT &strLike) {
+    { strLike.c_str() } -> std::same_as<const CharT *>;
+  };
+
+#ifndef C_STR_BUILDER_SLIM
   /// @brief Concept to ensure `StrLikeT` is a contiguous sequence of `CharT`
-  ///        elements.
+  ///        elements with a known size.
+  template<class StrLikeT, class CharT>
+  concept contiguous_string_like_of_type =
+    std::ranges::contiguous_range<StrLikeT> && std::ranges::sized_range<StrLikeT> && std::same_as<std::ranges::range_value_t<StrLikeT>, CharT>;
+
+  /// @brief Concept to ensure `StrLikeT` is a non-contiguous sequence of
+  ///        `CharT` elements (e.g. `std::deque`, `std::list`, or a
+  ///        `std::ranges::join_view` of string chunks) that can be iterated
+  ///        through a constant reference.
+  template<class StrLikeT, class CharT>
+  concept segmented_string_like_of_type =
+    !contiguous_string_like_of_type<StrLikeT, CharT> && std::ranges::input_range<const StrLikeT> && std::same_as<std::ranges::range_value_t<const StrLikeT>, CharT>;
+#else
+  // The slim configuration relies on the range access functions `std::data()`, `std::size()`, `std::begin()`, and `std::end()` which are declared in <string>.
+  template<class StrLikeT, class CharT>
+  concept contiguous_string_like_of_type = requires(const StrLikeT &strLike) {
+    { std::data(strLike) } -> std::convertible_to<const CharT *>;
+    { std::size(strLike) } -> std::convertible_to<std::size_t>;
+  } && std::same_as<std::remove_cvref_t<decltype(*std::data(std::declval<const StrLikeT &>()))>, CharT>;
+
+  template<class StrLikeT, class CharT>
+  concept segmented_string_like_of_type = !contiguous_string_like_of_type<StrLikeT, CharT> && requires(const StrLikeT &strLike) {
+    std::begin(strLike) != std::end(strLike);
+    ++std::declval<decltype(std::begin(strLike)) &>();
+  } && std::same_as<std::remove_cvref_t<decltype(*std::begin(std::declval<const StrLikeT &>()))>, CharT>;
+#endif
+
+  /// @brief Concept to ensure `StrLikeT` is a sequence of `CharT` elements.
   template<class StrLikeT, class CharT>
   concept string_like_of_type =
-    (std::ranges::contiguous_range<StrLikeT> && std::ranges::sized_range<StrLikeT> && std::same_as<std::ranges::range_value_t<StrLikeT>, CharT>) ||
-    (std::same_as<StrLikeT, std::filesystem::path> && std::same_as<CharT, std::filesystem::path::value_type>) ||
+    terminated_string_like_of_type<StrLikeT, CharT> ||
+    null_terminated_range_of_type<StrLikeT, CharT> ||
+    contiguous_string_like_of_type<StrLikeT, CharT> ||
+    segmented_string_like_of_type<StrLikeT, CharT> ||
     (std::is_pointer_v<StrLikeT> && std::convertible_to<StrLikeT, const CharT *>);
 
-  /// @brief Concept to ensure a contiguous sequence of `char` elements in the
+  /// @brief Concept to ensure a sequence of `char` elements in the
   ///        referenced buffer.
   template<class StrLikeT>
   concept string_like = string_like_of_type<StrLikeT, char>;
 
-  /// @brief Concept to ensure a contiguous sequence of `wchar_t` elements in
-  ///        the referenced buffer.
+  /// @brief Concept to ensure a sequence of `wchar_t` elements in the
+  ///        referenced buffer.
   template<class StrLikeT>
   concept wstring_like = string_like_of_type<StrLikeT, wchar_t>;
 
-  /// @brief Concept to ensure a contiguous sequence of `char8_t` elements in
-  ///        the referenced buffer.
+  /// @brief Concept to ensure a sequence of `char8_t` elements in the
+  ///        referenced buffer.
   template<class StrLikeT>
   concept u8string_like = string_like_of_type<StrLikeT, char8_t>;
 
-  /// @brief Concept to ensure a contiguous sequence of `char16_t` elements in
-  ///        the referenced buffer.
+  /// @brief Concept to ensure a sequence of `char16_t` elements in the
+  ///        referenced buffer.
   template<class StrLikeT>
   concept u16string_like = string_like_of_type<StrLikeT, char16_t>;
 
-  /// @brief Concept to ensure a contiguous sequence of `char32_t` elements in
-  ///        the referenced buffer.
+  /// @brief Concept to ensure a sequence of `char32_t` elements in the
+  ///        referenced buffer.
   template<class StrLikeT>
   concept u32string_like = string_like_of_type<StrLikeT, char32_t>;
 
@@ -94,6 +234,457 @@ namespace c_str
     keep_null_pointer
   };
 
+  /// @brief Operation on a `c_str::basic_builder` object reported in a
+  ///        trace. For more information see @ref Trace.
+  enum class trace_op : std::uint8_t
+  {
+    construct,
+    copy_construct,
+    move_construct,
+    copy_assign,
+    move_assign,
+    swap,
+    overwrite,
+    destroy
+  };
+
+  /// @brief Kind of the string-like object a `c_str::basic_builder` object is
+  ///        constructed from, reported in a trace. For more information see
+  ///        @ref Trace.
+  enum class trace_source : std::uint8_t
+  {
+    null_pointer, ///< `nullptr` or a null pointer to `CharT`
+    pointer, ///< pointer to a null-terminated string
+    terminated, ///< object with a `c_str()` member function
+    null_terminated_range, ///< pointer and `c_str::null_sentinel_t`
+    contiguous, ///< contiguous sequence, e.g. `std::basic_string_view`
+    segmented, ///< segmented sequence, e.g. `std::deque`
+    builder, ///< other `c_str::basic_builder` object (copy, move, swap)
+    written ///< buffer written by `for_overwrite()` or taken over by `adopt()`
+  };
+
+#ifdef C_STR_BUILDER_TRACE
+  /// @brief Event passed to the `c_str::trace_hook` function.
+  struct trace_event
+  {
+    trace_op op; ///< operation
+    trace_source source; ///< kind of the source
+    std::uint8_t char_size; ///< size of the character type in bytes
+    bool terminated; ///< `false` if the object owns a copy of the C-string
+    std::size_t length; ///< length of the C-string after the operation
+    const void *object; ///< address of the object, identifies it until destroyed
+    const void *other; ///< address of the other object of a copy, move, or swap
+  };
+
+  /// @brief Type of the function receiving the trace events.
+  using trace_hook_type = void (*)(const trace_event &) noexcept;
+
+  /// @brief Function receiving the trace events of all `c_str::basic_builder`
+  ///        objects, or a null pointer if no trace is captured. See
+  ///        @ref Trace.
+  inline std::atomic<trace_hook_type> trace_hook{};
+#endif
+
+  /// @brief Trait telling whether objects of type `T` can be relocated by
+  ///        copying their bytes (e.g. using `std::memcpy`), which ends the
+  ///        lifetime of the source objects without calling their destructors.
+  ///
+  /// Trivially copyable types are trivially relocatable. `c_str::basic_builder`
+  /// and `c_str::basic_owned_buffer` are trivially relocatable if their
+  /// allocator is stateless or trivially relocatable. If `C_STR_BUILDER_TRACE`
+  /// is defined, `c_str::basic_builder` is not, so that relocated objects are
+  /// traced like moved ones (see @ref Trace). The trait can be specialized for
+  /// further types. See `c_str::uninitialized_relocate()`.
+  template<class T>
+  struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>>
+  {
+  };
+
+  /// @brief Value of the `c_str::is_trivially_relocatable` trait.
+  template<class T>
+  inline constexpr bool is_trivially_relocatable_v{ is_trivially_relocatable<T>::value };
+
+  /// @brief The `c_str::uninitialized_relocate()` function moves the objects
+  ///        of the range [`first`, `last`) into the uninitialized memory at
+  ///        `dest`, and ends their lifetime.
+  ///
+  /// Trivially relocatable objects (see `c_str::is_trivially_relocatable`)
+  /// are moved using a single `std::memmove`, others are move-constructed and
+  /// destroyed one by one. This lets a container or cache of
+  /// `c_str::basic_builder` objects grow without calling their move
+  /// constructors and destructors.
+  /// @param first  Pointer to the first object to be relocated.
+  /// @param last   Pointer behind the last object to be relocated.
+  /// @param dest   Pointer to uninitialized memory for `last - first` objects.
+  /// @return Pointer behind the last relocated object in `dest`.
+  template<class T>
+  T *uninitialized_relocate(T *first, T *const last, T *dest) noexcept(is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>)
+  {
+    if constexpr (is_trivially_relocatable_v<T>)
+    {
+      const auto count{ static_cast<std::size_t>(last - first) };
+      if (count)
+        std::memmove(static_cast<void *>(dest), static_cast<const void *>(first), count * sizeof(T));
+
+      return dest + count;
+    }
+    else
+    {
+      for (; first != last; ++first, ++dest)
+      {
+        std::construct_at(dest, std::move(*first));
+        std::destroy_at(first);
+      }
+
+      return dest;
+    }
+  }
+
+  /// @brief The `c_str::basic_owned_buffer` class template is the owned string
+  ///        buffer of `c_str::basic_builder`.
+  ///
+  /// It holds a null-terminated sequence of characters like a
+  /// `std::basic_string`, with a subset of its interface. Up to
+  /// `local_capacity` characters are kept in a small-string buffer inside of
+  /// the object. Other than in a `std::basic_string`, no pointer refers to it.
+  /// `data()` checks whether memory is allocated, and provides the address of
+  /// the small-string buffer otherwise. Thus, the object is trivially
+  /// relocatable if the allocator is. Moving or swapping objects doesn't
+  /// change the addresses of allocated characters. The small-string buffer is
+  /// only used with stateless allocators that specify neither a `padding` nor
+  /// an `alignment` constant, as the characters of a stateful allocator may
+  /// have to be in particular memory (e.g. in shared memory), and the
+  /// small-string buffer can't be padded or aligned. A default-constructed
+  /// object doesn't allocate.
+  /// @tparam CharT       Value type of the characters.
+  /// @tparam AllocatorT  Allocator type used to allocate the buffer.
+  template<common_char_type CharT, class AllocatorT = std::allocator<CharT>>
+  class basic_owned_buffer
+  {
+  public:
+    /// @brief Character type of the `CharT` template parameter.
+    using value_type = CharT;
+
+    /// @brief Traits type of the characters.
+    using traits_type = std::char_traits<value_type>;
+
+    /// @brief Allocator type of the `AllocatorT` template parameter.
+    using allocator_type = AllocatorT;
+
+    /// @brief Type of sizes.
+    using size_type = std::size_t;
+
+    /// @brief Number of characters kept in the small-string buffer, 0 if it
+    ///        is not used with the allocator (see above).
+    static constexpr size_type local_capacity{ std::allocator_traits<allocator_type>::is_always_equal::value &&
+                                                   !requires { allocator_type::padding; } &&
+                                                   !requires { allocator_type::alignment; } ?
+                                                 16 / sizeof(value_type) - 1 :
+                                                 0 };
+
+  private:
+    using _alloc_traits = std::allocator_traits<allocator_type>;
+    static_assert(std::is_same_v<typename _alloc_traits::pointer, value_type *>, "the allocator is required to allocate raw pointers");
+
+    union _storage
+    {
+      value_type local[local_capacity + 1]; // small-string buffer, the active member as long as nothing is allocated
+      size_type capacity; // number of characters that fit into the allocated buffer
+    };
+
+    C_STR_NO_UNIQUE_ADDRESS_ allocator_type _m_alloc{};
+    value_type *_m_data{}; // allocated buffer of `_m_storage.capacity + 1` characters, or null if the characters are in `_m_storage.local`; the characters behind `_m_size` are unspecified except the terminating null
+    size_type _m_size{};
+    _storage _m_storage{};
+
+    constexpr inline void _deallocate() noexcept
+    {
+      if (_m_data)
+        _alloc_traits::deallocate(_m_alloc, _m_data, _m_storage.capacity + 1);
+    }
+
+    constexpr inline void _release() noexcept
+    {
+      _deallocate();
+      _m_data = nullptr;
+      _m_size = 0;
+      std::construct_at(std::addressof(_m_storage)); // the empty small-string buffer becomes the active member again
+    }
+
+    // takes over the characters of `other` which is empty afterwards, requires nothing to be allocated by this object
+    constexpr inline void _steal(basic_owned_buffer &other) noexcept
+    {
+      _m_data = std::exchange(other._m_data, nullptr);
+      _m_size = std::exchange(other._m_size, size_type{});
+      _m_storage = other._m_storage; // either the capacity of the taken buffer, or a copy of the small-string buffer
+      std::construct_at(std::addressof(other._m_storage));
+    }
+
+    // replaces the buffer with one of `capacity` characters, keeping the characters
+    constexpr inline void _reallocate(const size_type capacity)
+    {
+      const auto buf{ _alloc_traits::allocate(_m_alloc, capacity + 1) };
+      if (std::is_constant_evaluated())
+        for (size_type idx{}; idx <= capacity; ++idx)
+          std::construct_at(buf + idx); // constant evaluation requires the lifetime of the characters to begin
+
+      if (_m_size)
+        traits_type::copy(buf, data(), _m_size);
+
+      traits_type::assign(buf[_m_size], value_type{});
+      _deallocate();
+      _m_data = buf;
+      _m_storage.capacity = capacity;
+    }
+
+    // makes room for `count` characters, growing geometrically for repeated appending
+    constexpr inline void _grow(const size_type count)
+    {
+      if (const auto current{ capacity() }; count > current)
+        _reallocate(count < current * 2 ? current * 2 : count);
+    }
+
+    constexpr inline void _set_size(const size_type count) noexcept
+    {
+      _m_size = count;
+      traits_type::assign(data()[count], value_type{});
+    }
+
+  public:
+    /// @brief Default constructor, doesn't allocate.
+    constexpr basic_owned_buffer() noexcept(std::is_nothrow_default_constructible_v<allocator_type>) = default;
+
+    /// @brief Create an empty object using a copy of `alloc`.
+    constexpr explicit basic_owned_buffer(const allocator_type &alloc) noexcept :
+      _m_alloc{ alloc }
+    {
+    }
+
+    /// @brief Copy constructor.
+    constexpr basic_owned_buffer(const basic_owned_buffer &other) :
+      _m_alloc{ _alloc_traits::select_on_container_copy_construction(other._m_alloc) }
+    {
+      assign(other.data(), other._m_size);
+    }
+
+    /// @brief Move constructor, takes over the buffer or copies the
+    ///        small-string buffer.
+    constexpr basic_owned_buffer(basic_owned_buffer &&other) noexcept :
+      _m_alloc{ std::move(other._m_alloc) }
+    {
+      _steal(other);
+    }
+
+    /// @brief Copy assignment operator.
+    constexpr basic_owned_buffer &operator=(const basic_owned_buffer &other)
+    {
+      if (this == std::addressof(other))
+        return *this;
+
+      if constexpr (_alloc_traits::propagate_on_container_copy_assignment::value)
+      {
+        if (!_alloc_traits::is_always_equal::value && !(_m_alloc == other._m_alloc))
+          _release(); // the buffer must be deallocated by the allocator that allocated it
+
+        _m_alloc = other._m_alloc;
+      }
+
+      return assign(other.data(), other._m_size);
+    }
+
+    /// @brief Move assignment operator. It takes over the buffer, unless the
+    ///        allocators are different and not propagated.
+    constexpr basic_owned_buffer &operator=(basic_owned_buffer &&other) noexcept(_alloc_traits::propagate_on_container_move_assignment::value ||
+                                                                                 _alloc_traits::is_always_equal::value)
+    {
+      if (this == std::addressof(other))
+        return *this;
+
+      if constexpr (_alloc_traits::propagate_on_container_move_assignment::value || _alloc_traits::is_always_equal::value)
+      {
+        _release();
+        if constexpr (_alloc_traits::propagate_on_container_move_assignment::value)
+          _m_alloc = std::move(other._m_alloc);
+
+        _steal(other);
+      }
+      else if (_m_alloc == other._m_alloc)
+      {
+        _release();
+        _steal(other);
+      }
+      else
+      {
+        assign(other.data(), other._m_size);
+        other._release();
+      }
+
+      return *this;
+    }
+
+    /// @brief Destructor.
+    constexpr ~basic_owned_buffer()
+    {
+      _deallocate();
+    }
+
+    /// @brief Provides a copy of the allocator.
+    constexpr allocator_type get_allocator() const noexcept
+    {
+      return _m_alloc;
+    }
+
+    /// @brief Provides a pointer to the characters, either in the allocated
+    ///        buffer or in the small-string buffer.
+    constexpr value_type *data() noexcept
+    {
+      return _m_data ? _m_data : _m_storage.local;
+    }
+
+    /// @brief Provides a pointer to the characters, either in the allocated
+    ///        buffer or in the small-string buffer.
+    constexpr const value_type *data() const noexcept
+    {
+      return _m_data ? _m_data : _m_storage.local;
+    }
+
+    /// @brief Provides a pointer to the null-terminated characters.
+    constexpr const value_type *c_str() const noexcept
+    {
+      return data();
+    }
+
+    /// @brief Provides the number of characters.
+    constexpr size_type size() const noexcept
+    {
+      return _m_size;
+    }
+
+    /// @brief Provides the number of characters that fit into the buffer.
+    constexpr size_type capacity() const noexcept
+    {
+      return _m_data ? _m_storage.capacity : local_capacity;
+    }
+
+    /// @brief Checks whether the characters are kept in the small-string
+    ///        buffer, i.e. nothing is allocated.
+    constexpr bool is_local() const noexcept
+    {
+      return !_m_data;
+    }
+
+    /// @brief Checks whether the object has no characters.
+    constexpr bool empty() const noexcept
+    {
+      return !_m_size;
+    }
+
+    /// @brief Removes the characters, the buffer is kept.
+    constexpr void clear() noexcept
+    {
+      _set_size(0);
+    }
+
+    /// @brief Makes the capacity at least `count` characters.
+    constexpr void reserve(const size_type count)
+    {
+      if (count > capacity())
+        _reallocate(count);
+    }
+
+    /// @brief Changes the number of characters to `count`, appended
+    ///        characters are zero.
+    constexpr void resize(const size_type count)
+    {
+      _grow(count);
+      if (count > _m_size)
+        traits_type::assign(data() + _m_size, count - _m_size, value_type{});
+
+      _set_size(count);
+    }
+
+    /// @brief Changes the number of characters to at most `count` like
+    ///        `std::basic_string::resize_and_overwrite()`, without
+    ///        initializing the characters `op` overwrites anyway.
+    /// @param count  Number of characters provided to `op`.
+    /// @param op     Function object receiving a pointer to the buffer and
+    ///               `count`, returning the resulting number of characters.
+    template<class OperationT>
+    constexpr void resize_and_overwrite(const size_type count, OperationT op)
+    {
+      _grow(count);
+      _set_size(static_cast<size_type>(std::move(op)(data(), count)));
+    }
+
+    /// @brief Appends `count` characters of `src`, which must not refer into
+    ///        this buffer.
+    constexpr basic_owned_buffer &append(const value_type *const src, const size_type count)
+    {
+      _grow(_m_size + count);
+      if (count)
+        traits_type::copy(data() + _m_size, src, count);
+
+      _set_size(_m_size + count);
+      return *this;
+    }
+
+    /// @brief Appends `count` copies of `ch`.
+    constexpr basic_owned_buffer &append(const size_type count, const value_type ch)
+    {
+      _grow(_m_size + count);
+      if (count)
+        traits_type::assign(data() + _m_size, count, ch);
+
+      _set_size(_m_size + count);
+      return *this;
+    }
+
+    /// @brief Appends `ch`.
+    constexpr void push_back(const value_type ch)
+    {
+      _grow(_m_size + 1);
+      traits_type::assign(data()[_m_size], ch);
+      _set_size(_m_size + 1);
+    }
+
+    /// @brief Replaces the characters with `count` characters of `src`, which
+    ///        must not refer into this buffer.
+    constexpr basic_owned_buffer &assign(const value_type *const src, const size_type count)
+    {
+      _m_size = 0; // nothing to keep if the buffer is reallocated
+      reserve(count);
+      if (count)
+        traits_type::copy(data(), src, count);
+
+      _set_size(count);
+      return *this;
+    }
+
+    /// @brief Exchanges the buffers. The addresses of allocated characters
+    ///        don't change, the small-string buffers are exchanged by value.
+    ///        The allocators are exchanged if they propagate on swap,
+    ///        otherwise they must be equal.
+    constexpr void swap(basic_owned_buffer &other) noexcept
+    {
+      if constexpr (_alloc_traits::propagate_on_container_swap::value)
+      {
+        using std::swap;
+        swap(_m_alloc, other._m_alloc);
+      }
+
+      std::swap(_m_data, other._m_data);
+      std::swap(_m_size, other._m_size);
+      std::swap(_m_storage, other._m_storage); // either the capacities, or the characters of small-string buffers, or one of each
+    }
+  };
+
+  /// @cond _NO_DOC_
+  template<common_char_type CharT, class AllocatorT>
+  struct is_trivially_relocatable<basic_owned_buffer<CharT, AllocatorT>> : std::bool_constant<std::is_empty_v<AllocatorT> || is_trivially_relocatable_v<AllocatorT>> // a stateless allocator has nothing to relocate
+  {
+  };
+  /// @endcond
+
   /// @brief The `c_str::basic_builder` class provides a C-string as a pointer
   ///        to an array of constant characters via its `get()` member function.
   ///
@@ -109,11 +700,19 @@ namespace c_str
   ///   array, `std::array`, `std::basic_string_view`, `std::initializer_list`,
   ///   `std::span`, or `std::vector` <br>
   ///   only the last character in the buffer is checked
+  /// - if the sequence is not contiguous like in a `std::deque`, a `std::list`,
+  ///   or a `std::ranges::join_view` of string chunks <br>
+  ///   the owned buffer is sized up front whenever the number of characters
+  ///   is known, and contiguous segments (like the chunks of a
+  ///   `std::ranges::join_view`) are copied as a whole
   ///
   /// Copying is left out
   /// - if the terminating null can be determined (see above)
   /// - if the object is a `std::basic_string` or `std::filesystem::path` where
-  ///   the buffer is guaranteed to be null-terminated
+  ///   the buffer is guaranteed to be null-terminated (generally, if the
+  ///   object has a `c_str()` member function returning `const CharT *`)
+  /// - if the object is a range of a pointer and a `c_str::null_sentinel_t`
+  ///   (like `std::ranges::subrange<const CharT *, c_str::null_sentinel_t>`)
   /// - if a null-terminated string referenced by a pointer is expected <br>
   ///   NOTE: the user is responsible for not passing a pointer to a memory
   ///   object that does not contain a terminating null; overall is the
@@ -125,6 +724,15 @@ namespace c_str
   /// make sure that neither the original string-like object nor the class
   /// instance expires while using the provided pointer.
   ///
+  /// Short copies are kept in the small-string buffer of the owned string
+  /// buffer (see `c_str::basic_owned_buffer`), longer ones are allocated. The
+  /// object never stores a pointer into itself, `get()` provides the owned
+  /// C-string from the owned string buffer instead. Moving an object is
+  /// `noexcept` and keeps the address of an allocated C-string. The class is
+  /// trivially relocatable (see `c_str::is_trivially_relocatable`) if the
+  /// allocator is stateless or trivially relocatable, and
+  /// `C_STR_BUILDER_TRACE` is not defined.
+  ///
   /// @anchor NullBehavior
   /// The `NullBehavior` template parameter specifies what pointer is provided
   /// if the class object is constructed from a null pointer (either the
@@ -137,12 +745,90 @@ namespace c_str
   /// The default behavior can be changed by defining the `DEF_NULL_BEHAVIOR`
   /// macro with `keep_null_pointer` before the header is included.
   ///
+  /// @anchor Slim
+  /// Defining the `C_STR_BUILDER_SLIM` macro before the header is included
+  /// selects a configuration that is faster to parse. It checks string-like
+  /// objects using the range access functions declared in <string> rather
+  /// than the concepts of <ranges>. The set of accepted objects is the same,
+  /// except that the chunks of a `std::ranges::join_view` are not copied as a
+  /// whole. A `std::filesystem::path` is still accepted through its `c_str()`
+  /// member function, without the header including <filesystem>. The macro
+  /// must be defined consistently in all translation units of a program.
+  ///
+  /// @anchor Comparison
+  /// `c_str::basic_builder` objects compare and hash by the content of their
+  /// C-strings, where a null pointer is treated like a zero-length string. A
+  /// specialization of `std::hash` is provided, and the
+  /// `c_str::transparent_hash` and `c_str::transparent_equal_to` function
+  /// objects enable heterogeneous lookup in unordered containers. The length
+  /// and the hash value are determined once and cached (see `length()` and
+  /// `hash()`), so repeated comparisons and lookups neither search the
+  /// terminating null nor hash the characters again. Copies take over the
+  /// cached values.
+  ///
+  /// @anchor Instantiation
+  /// Defining the `C_STR_BUILDER_EXTERN_TEMPLATES` macro before the header is
+  /// included declares the specializations of the `c_str::builder`,
+  /// `c_str::wbuilder`, `c_str::u8builder`, `c_str::u16builder`, and
+  /// `c_str::u32builder` types for both `c_str::if_null` values as explicitly
+  /// instantiated elsewhere, along with their constructors from pointers,
+  /// `std::basic_string`, and `std::basic_string_view`. c_str_builder.cpp
+  /// provides the explicit instantiation definitions and must be linked then.
+  /// (The c_str.cppm module interface unit contains them as well, for the
+  /// importers of the module.) Only the member functions which are not
+  /// `constexpr`, like `hash()`, `has_safe_padding()`, and the large-copy tier,
+  /// are defined out of line and thus no longer instantiated in every
+  /// translation unit. The `constexpr` member functions, including the
+  /// constructors, are implicitly inline and still instantiated where they are
+  /// used. Note: The declarations instantiate the class definitions of all ten
+  /// specializations in every translation unit. With GCC 12, a translation unit
+  /// of bench/compile_time.sh results in an object file of about 4.7 KB instead
+  /// of 5.9 KB at -O2 (7 KB instead of 38 KB at -O0), but its compile time
+  /// rather increases by about 0.1 s (8 %).
+  ///
+  /// @anchor LargeCopy
+  /// Strings of at least `C_STR_LARGE_COPY_THRESHOLD` bytes are copied into
+  /// the owned buffer using non-temporal (streaming) stores where the target
+  /// supports SSE2, in order to keep the copied data from evicting hot data
+  /// out of the cache. On Linux the buffer is also advised to be backed by
+  /// transparent huge pages. If `C_STR_LARGE_COPY_THREADS` is defined with a
+  /// value greater than 1, strings of at least `C_STR_PARALLEL_COPY_THRESHOLD`
+  /// bytes are copied using that number of threads. Defining
+  /// `C_STR_LARGE_COPY_THRESHOLD` with 0 disables the large-copy tier. Strings
+  /// below the threshold are copied like before. <br>
+  /// The owned buffer itself is obtained from the `AllocatorT` allocator.
+  /// `c_str::large_page_allocator` (see c_str_large_page_allocator.hpp) maps
+  /// large buffers directly from the operating system.
+  ///
+  /// @anchor Trace
+  /// Defining the `C_STR_BUILDER_TRACE` macro before the header is included
+  /// enables the capture mode. Construction, copy, move, swap, and destruction
+  /// are then reported as `c_str::trace_event` to the function assigned to
+  /// `c_str::trace_hook`, which is null by default. The length of the C-string
+  /// is determined for every event, so the capture mode is meant to record a
+  /// workload once (see c_str_trace.hpp) rather than for production builds.
+  /// The macro must be defined consistently in all translation units of a
+  /// program.
+  ///
+  /// @anchor Padding
+  /// SIMD parsers may read a few bytes beyond the end of their input and
+  /// benefit from aligned input. If the `AllocatorT` allocator specifies a
+  /// `padding` constant, the owned buffer is followed by that number of zero
+  /// bytes behind the terminating null. The alignment of the owned buffer is
+  /// up to the allocator. `c_str::padded_allocator` (see
+  /// c_str_padded_allocator.hpp) pads and aligns to the size of a cache line by
+  /// default. The `has_safe_padding()` and `is_aligned()` member functions
+  /// tell whether the provided pointer can be passed to such a parser as is,
+  /// which also covers strings that have not been copied.
+  ///
   /// @tparam CharT         Value type of the characters. Requires to meet the
   ///                       `c_str::common_char_type` concept.
   /// @tparam NullBehavior  Value of the `c_str::if_null` enumeration,
   ///                       specifying the behavior of the class if constructed
   ///                       from a null pointer.
-  template<common_char_type CharT, if_null NullBehavior = if_null::DEF_NULL_BEHAVIOR>
+  /// @tparam AllocatorT    Allocator type used to allocate the owned string
+  ///                       buffer.
+  template<common_char_type CharT, if_null NullBehavior = if_null::DEF_NULL_BEHAVIOR, class AllocatorT = std::allocator<CharT>>
   class basic_builder
   {
   public:
@@ -161,32 +847,245 @@ namespace c_str
     ///        `c_str::basic_builder::length()` member function.
     using size_type = std::size_t;
 
+    /// @brief Type of the owned string buffer, see `adopt()`.
+    using string_type = basic_owned_buffer<value_type, AllocatorT>;
+
     /// @brief Value of the `NullBehavior` template parameter.
     static constexpr if_null null_behavior{ NullBehavior };
 
+    /// @brief Number of zero bytes following the terminating null in an owned
+    ///        string buffer. It is taken from the `padding` constant of the
+    ///        `AllocatorT` allocator (rounded up to whole characters), or is 0
+    ///        if the allocator doesn't specify it. See @ref Padding for more
+    ///        information.
+    static constexpr std::size_t padding_bytes{ []() {
+      if constexpr (requires { { AllocatorT::padding } -> std::convertible_to<std::size_t>; })
+        return (static_cast<std::size_t>(AllocatorT::padding) + sizeof(CharT) - 1) / sizeof(CharT) * sizeof(CharT);
+      else
+        return std::size_t{};
+    }() };
+
   private:
+    static constexpr size_type _m_unknown{ ~size_type{} }; // value of `_m_length` as long as the length is not determined
+    static constexpr size_type _m_hashed{ ~(~size_type{} >> 1) }; // flag in `_m_length` telling that `_m_hash` is valid
     static constexpr value_type _m_zero{}; // used instead of the default-constructed _m_zero_suffixed to avoid [clang-analyzer-cplusplus.InnerPointer] annotations
-    std::basic_string<value_type> _m_zero_suffixed{}; // if a string-like object is not yet null-terminated, it will be copied to a `std::basic_string` as the character sequence is guaranteed to get NUL-suffixed in its buffer
-    const_pointer _m_ptr{}; // holds the resulting C-string
+    string_type _m_zero_suffixed{}; // if a string-like object is not yet null-terminated, it will be copied to a `c_str::basic_owned_buffer` as the character sequence is guaranteed to get NUL-suffixed in its buffer; it is empty unless it holds the resulting C-string
+    const_pointer _m_ptr{}; // holds the resulting C-string if it is not owned, null otherwise; an owned C-string is provided by `_m_zero_suffixed` so that the object never refers into itself
+    mutable size_type _m_length{ _m_unknown }; // length of the C-string along with the `_m_hashed` flag, determined with the first use
+    mutable std::size_t _m_hash{}; // hash value of the C-string, valid if `_m_length` has the `_m_hashed` flag
 
     using _traits_type = typename decltype(_m_zero_suffixed)::traits_type; // type of the char_traits class, used for character operations
     using _allocator_type = typename decltype(_m_zero_suffixed)::allocator_type; // type of the allocator class, used for the owned string buffer
+    static constexpr size_type _padding{ padding_bytes / sizeof(value_type) }; // number of zero characters following the terminating null in the owned buffer
 
     template<typename T>
-    struct _is_basic_string : std::false_type
+    struct _is_join_view : std::false_type
     {
     };
 
-    template<class CharacterT, class TraitsT, class AllocT>
-    struct _is_basic_string<std::basic_string<CharacterT, TraitsT, AllocT>> : std::true_type
+#ifndef C_STR_BUILDER_SLIM
+    template<class ViewT>
+    struct _is_join_view<std::ranges::join_view<ViewT>> : std::true_type
     {
     };
 
+    template<class StrLikeT>
+    static constexpr inline const value_type *_data_of(const StrLikeT &strLike) noexcept
+    {
+      return std::ranges::cdata(strLike);
+    }
+
+    template<class StrLikeT>
+    static constexpr inline size_type _size_of(const StrLikeT &strLike) noexcept
+    {
+      return static_cast<size_type>(std::ranges::size(strLike));
+    }
+#else
+    template<class StrLikeT>
+    static constexpr inline const value_type *_data_of(const StrLikeT &strLike) noexcept
+    {
+      return std::data(strLike);
+    }
+
+    template<class StrLikeT>
+    static constexpr inline size_type _size_of(const StrLikeT &strLike) noexcept
+    {
+      return static_cast<size_type>(std::size(strLike));
+    }
+#endif
+
+#if C_STR_LARGE_COPY_THRESHOLD > 0
+    static constexpr size_type _large_copy_threshold{ (C_STR_LARGE_COPY_THRESHOLD + sizeof(value_type) - 1) / sizeof(value_type) }; // number of characters from which on the large-copy tier is used
+
+    static void _advise_huge_pages(void *buf, std::size_t bytes) noexcept;
+    static void _stream_copy(void *dest, const void *src, std::size_t bytes) noexcept;
+    static void _large_copy(value_type *dest, const value_type *src, size_type count);
+    // the large-copy tier is kept out of line, so that neither its code nor its copy sizes are seen where the small copies are inlined
+    C_STR_COLD_ void _assign_large(const value_type *src, size_type count);
+#endif
+
+    template<class WriterT>
+    constexpr inline void _append_for_overwrite(const size_type count, WriterT writer)
+    {
+      const auto offset{ _m_zero_suffixed.size() };
+      _m_zero_suffixed.resize_and_overwrite(offset + count, [&writer, offset](value_type *const buf, const size_type bufSize) {
+        writer(buf + offset);
+        return bufSize;
+      }); // avoid zero-initializing characters that get overwritten anyway
+    }
+
+    // number of characters up to the first null, at most `count`
+    static constexpr inline size_type _length_within(const value_type *const src, const size_type count) noexcept
+    {
+      const auto null{ _traits_type::find(src, count, value_type{}) };
+      return null ? static_cast<size_type>(null - src) : count;
+    }
+
+    // strings compared via a string view; `basic_builder` itself is excluded, which would make the comparison with string literals ambiguous
+    template<class StrT>
+    static constexpr bool _comparable_string = !std::is_same_v<StrT, basic_builder> &&
+                                               (std::is_null_pointer_v<StrT> || std::is_convertible_v<const StrT &, std::basic_string_view<value_type>>);
+
+    template<class StrT>
+    static constexpr inline std::basic_string_view<value_type> _view_of(const StrT &str) noexcept
+    {
+      if constexpr (std::is_null_pointer_v<StrT>)
+        return {};
+      else if constexpr (std::is_pointer_v<StrT>)
+        return str ? std::basic_string_view<value_type>{ str } : std::basic_string_view<value_type>{};
+      else
+        return std::basic_string_view<value_type>{ str };
+    }
+
+    constexpr inline void _assign_zero_suffixed(const value_type *const src, const size_type count)
+    {
+#if C_STR_LARGE_COPY_THRESHOLD > 0
+      if (!std::is_constant_evaluated() && count >= _large_copy_threshold) [[unlikely]]
+      {
+        _assign_large(src, count);
+        return;
+      }
+#endif
+      if constexpr (_padding != 0)
+      {
+        _m_zero_suffixed.reserve(count + _padding);
+        _m_zero_suffixed.assign(src, count).append(_padding, value_type{});
+      }
+      else
+        _m_zero_suffixed.assign(src, count);
+    }
+
+    // value of `_m_ptr` after `_m_zero_suffixed` has been filled, the zero-length string if nothing was copied
+    constexpr inline const_pointer _owned_ptr() const noexcept
+    {
+      return _m_zero_suffixed.empty() ? std::addressof(_m_zero) : nullptr;
+    }
+
+    constexpr inline size_type _find_length() const noexcept
+    {
+      if (is_owning()) // an embedded null may precede the end of the owned buffer
+        return _length_within(_m_zero_suffixed.data(), _m_zero_suffixed.size() - _padding);
+
+      if constexpr (null_behavior == if_null::make_zero_length)
+        return _traits_type::length(_m_ptr);
+      else
+        return _m_ptr ? _traits_type::length(_m_ptr) : size_type{};
+    }
+
+    // takes the cached length and hash value of `other`, which may be determined by another thread at the same time
+    constexpr inline void _copy_cache(const basic_builder &other) noexcept
+    {
+      if (std::is_constant_evaluated())
+      {
+        _m_length = _m_unknown; // nothing is cached during constant evaluation
+        return;
+      }
+
+      const auto state{ std::atomic_ref<size_type>{ other._m_length }.load(std::memory_order_acquire) };
+      _m_hash = std::atomic_ref<std::size_t>{ other._m_hash }.load(std::memory_order_relaxed);
+      _m_length = state;
+    }
+
+    // takes the cached length and hash value of `other` which is moved
+    constexpr inline void _take_cache(basic_builder &other) noexcept
+    {
+      if (std::is_constant_evaluated())
+        return; // nothing is cached during constant evaluation
+
+      _m_length = std::exchange(other._m_length, _m_unknown);
+      _m_hash = other._m_hash;
+    }
+
+    template<class SegmentT>
+    constexpr inline void _append_segment(const SegmentT &segment)
+    {
+      if constexpr (contiguous_string_like_of_type<SegmentT, value_type>)
+        _m_zero_suffixed.append(_data_of(segment), _size_of(segment)); // one block copy
+#ifndef C_STR_BUILDER_SLIM
+      else if constexpr (std::ranges::sized_range<const SegmentT> && std::ranges::common_range<const SegmentT>)
+        _append_for_overwrite(static_cast<size_type>(std::ranges::size(segment)), [&segment](value_type *const dest) {
+          std::copy(std::ranges::begin(segment), std::ranges::end(segment), dest); // the standard library copies segmented iterators (like those of `std::deque`) block by block
+        });
+#else
+      else if constexpr (requires { std::size(segment); })
+        _append_for_overwrite(static_cast<size_type>(std::size(segment)), [&segment](value_type *dest) {
+          for (auto it{ std::begin(segment) }; it != std::end(segment); ++it, ++dest)
+            *dest = *it;
+        });
+#endif
+      else
+        for (const auto &ch : segment)
+          _m_zero_suffixed.push_back(ch);
+    }
+
+    template<class StrLikeT>
+    constexpr inline const_pointer _copy_segmented(const StrLikeT &strLike)
+    {
+#ifndef C_STR_BUILDER_SLIM
+      if constexpr (_is_join_view<StrLikeT>::value && requires { strLike.base(); }) // the chunks of the joined view are available
+      {
+        const auto segments{ strLike.base() };
+        using segment_type = std::ranges::range_reference_t<const decltype(segments)>;
+        if constexpr (std::ranges::forward_range<const decltype(segments)> && std::ranges::sized_range<std::remove_reference_t<segment_type>>)
+        {
+          size_type total{};
+          for (const auto &segment : segments)
+            total += static_cast<size_type>(std::ranges::size(segment));
+
+          _m_zero_suffixed.reserve(total + _padding);
+        }
+
+        for (const auto &segment : segments)
+          _append_segment(segment);
+      }
+      else
+      {
+        if constexpr (std::ranges::sized_range<const StrLikeT>)
+          _m_zero_suffixed.reserve(static_cast<size_type>(std::ranges::size(strLike)) + _padding);
+
+        _append_segment(strLike);
+      }
+#else
+      if constexpr (requires { std::size(strLike); })
+        _m_zero_suffixed.reserve(static_cast<size_type>(std::size(strLike)) + _padding);
+
+      _append_segment(strLike);
+#endif
+
+      if (_m_zero_suffixed.empty()) // zero-size object found => zero-length C string
+        return std::addressof(_m_zero);
+
+      if constexpr (_padding != 0)
+        _m_zero_suffixed.append(_padding, value_type{});
+
+      return nullptr; // provided by `_m_zero_suffixed`
+    }
+
     template<class StrLikeT>
     constexpr inline const_pointer _get_ptr(const StrLikeT &strLike) noexcept(std::is_null_pointer_v<StrLikeT> ||
                                                                               std::is_pointer_v<StrLikeT> ||
-                                                                              _is_basic_string<StrLikeT>::value ||
-                                                                              std::same_as<StrLikeT, std::filesystem::path>)
+                                                                              terminated_string_like_of_type<StrLikeT, value_type> ||
+                                                                              null_terminated_range_of_type<StrLikeT, value_type>)
     {
       if constexpr (std::is_null_pointer_v<StrLikeT> && null_behavior == if_null::make_zero_length)
         return std::addressof(_m_zero); // => zero-length C string
@@ -194,46 +1093,88 @@ namespace c_str
         return strLike; // => null pointer to `CharT`
       else if constexpr (std::is_pointer_v<StrLikeT>)
         return !strLike ? _get_ptr(nullptr) : strLike; // treat a null pointer to `CharT` as `nullptr`; if not null, we have to **rely** on the user passing a null-terminated string => don't copy
-      else if constexpr (_is_basic_string<StrLikeT>::value || std::same_as<StrLikeT, std::filesystem::path>)
+      else if constexpr (terminated_string_like_of_type<StrLikeT, value_type>) // e.g. std::basic_string, std::filesystem::path
         return strLike.c_str(); // the string buffer is already null-terminated => don't copy
+      else if constexpr (null_terminated_range_of_type<StrLikeT, value_type>) // e.g. std::ranges::subrange<const CharT *, c_str::null_sentinel_t>
+        return _get_ptr(static_cast<const_pointer>(strLike.begin())); // the sequence ends at the terminating null => don't copy
+      else if constexpr (segmented_string_like_of_type<StrLikeT, value_type>) // the characters are not in a contiguous buffer (e.g. std::deque, std::list, std::ranges::join_view - of value type CharT) => copy
+        return _copy_segmented(strLike);
       else // the buffer may or may not be null-terminated (e.g. string/array literal, std::array, std::basic_string_view, std::initializer_list, std::span, std::vector - of value type CharT)
-        return std::ranges::empty(strLike) ? // zero-size object found => zero-length C string
-                 std::addressof(_m_zero) :
-                 *std::ranges::crbegin(strLike) ? // no NUL character found at the end of the sequence => copy
-                   _m_zero_suffixed.assign(std::ranges::cdata(strLike), std::ranges::size(strLike)).c_str() :
-                   std::ranges::cdata(strLike); // terminating null found => don't copy
+      {
+        if (!_size_of(strLike)) // zero-size object found => zero-length C string
+          return std::addressof(_m_zero);
+
+        if (!_data_of(strLike)[_size_of(strLike) - 1]) // terminating null found => don't copy
+          return _data_of(strLike);
+
+        _assign_zero_suffixed(_data_of(strLike), _size_of(strLike)); // no NUL character found at the end of the sequence => copy, the length is determined with its first use
+        return _owned_ptr();
+      }
     }
 
     constexpr inline void _copy_used_member(const basic_builder &other)
     {
-      if (other._m_zero_suffixed.c_str() == other._m_ptr) // `_m_zero_suffixed` is used
+      if (other.is_owning()) // `_m_zero_suffixed` is used
       {
-        _m_zero_suffixed = other._m_zero_suffixed;
-        _m_ptr = _m_zero_suffixed.c_str();
+        if constexpr (std::allocator_traits<_allocator_type>::is_always_equal::value) // no allocator to propagate, thus the size-tiered copy is applicable
+          _assign_zero_suffixed(other._m_zero_suffixed.data(), other._m_zero_suffixed.size() - _padding); // the padding gets appended anew
+        else
+          _m_zero_suffixed = other._m_zero_suffixed;
       }
-      else // `_m_zero_suffixed` is only default-constructed and unused, so we can safely ignore it
-        _m_ptr = other._m_ptr;
+      else // `_m_zero_suffixed` is unused, its buffer is kept for later use
+        _m_zero_suffixed.clear();
+
+      _m_ptr = other._m_ptr;
+      _copy_cache(other);
     }
 
     constexpr inline void _move_used_member(basic_builder &&other) noexcept(std::is_nothrow_default_constructible_v<_allocator_type> &&
                                                                             (std::allocator_traits<_allocator_type>::propagate_on_container_move_assignment::value ||
                                                                              std::allocator_traits<_allocator_type>::is_always_equal::value))
     {
-      if (other._m_zero_suffixed.c_str() == other._m_ptr) // `_m_zero_suffixed` is used
-      {
-        _m_zero_suffixed = std::move(other._m_zero_suffixed);
-        other._m_zero_suffixed = {}; // this also helps the compiler optimize the code by making it clear that data can actually be moved in the previous operation
-        _m_ptr = _m_zero_suffixed.c_str();
-      }
-      else // `_m_zero_suffixed` is only default-constructed and unused, so we can safely ignore it
-        _m_ptr = std::move(other._m_ptr);
+      _m_zero_suffixed = std::move(other._m_zero_suffixed); // takes over the buffer (or the characters in its small-string buffer), unless the allocators are different and not propagated
+      _m_ptr = std::exchange(other._m_ptr, other._get_ptr(nullptr));
+      _take_cache(other);
+    }
 
-      if constexpr (null_behavior == if_null::make_zero_length)
-        other._m_ptr = std::addressof(_m_zero);
+#ifdef C_STR_BUILDER_TRACE
+    template<class StrLikeT>
+    static consteval trace_source _trace_source_of() noexcept
+    {
+      if constexpr (std::is_null_pointer_v<StrLikeT>)
+        return trace_source::null_pointer;
+      else if constexpr (std::is_pointer_v<StrLikeT>)
+        return trace_source::pointer; // a null pointer to `CharT` is reported at runtime by the `_trace()` function
+      else if constexpr (terminated_string_like_of_type<StrLikeT, value_type>)
+        return trace_source::terminated;
+      else if constexpr (null_terminated_range_of_type<StrLikeT, value_type>)
+        return trace_source::null_terminated_range;
+      else if constexpr (segmented_string_like_of_type<StrLikeT, value_type>)
+        return trace_source::segmented;
       else
-        other._m_ptr = nullptr;
+        return trace_source::contiguous;
     }
 
+    constexpr inline void _trace(const trace_op op, const trace_source source, const void *const other) const noexcept
+    {
+      if (std::is_constant_evaluated())
+        return;
+
+      const auto hook{ trace_hook.load(std::memory_order_acquire) };
+      if (!hook)
+        return;
+
+      const auto isNull{ source == trace_source::pointer && (!get() || get() == std::addressof(_m_zero)) }; // null pointer to `CharT`
+      hook(trace_event{ op,
+                        isNull ? trace_source::null_pointer : source,
+                        static_cast<std::uint8_t>(sizeof(value_type)),
+                        !is_owning(),
+                        length(),
+                        this,
+                        other });
+    }
+#endif
+
   public:
     /// @brief Default constructor that creates a `c_str::basic_builder` object
     ///        like it was constructed from `nullptr`.
@@ -243,6 +1184,9 @@ namespace c_str
     constexpr basic_builder() noexcept(std::is_nothrow_default_constructible_v<_allocator_type>) :
       _m_ptr{ _get_ptr(nullptr) }
     {
+#ifdef C_STR_BUILDER_TRACE
+      _trace(trace_op::construct, trace_source::null_pointer, nullptr);
+#endif
     }
 
     /// @brief Create a `c_str::basic_builder` object from a string-like object.
@@ -254,12 +1198,15 @@ namespace c_str
     constexpr basic_builder(const StrLikeT &strLike) noexcept(std::is_nothrow_default_constructible_v<_allocator_type> &&
                                                               (std::is_null_pointer_v<StrLikeT> ||
                                                                std::is_pointer_v<StrLikeT> ||
-                                                               _is_basic_string<StrLikeT>::value ||
-                                                               std::same_as<StrLikeT, std::filesystem::path>))
+                                                               terminated_string_like_of_type<StrLikeT, value_type> ||
+                                                               null_terminated_range_of_type<StrLikeT, value_type>))
       requires std::is_null_pointer_v<StrLikeT> || string_like_of_type<StrLikeT, value_type>
       :
       _m_ptr{ _get_ptr(strLike) }
     {
+#ifdef C_STR_BUILDER_TRACE
+      _trace(trace_op::construct, _trace_source_of<StrLikeT>(), nullptr);
+#endif
     }
 
     /// @brief Copy constructor.
@@ -267,15 +1214,23 @@ namespace c_str
     constexpr basic_builder(const basic_builder &other)
     {
       _copy_used_member(other);
+#ifdef C_STR_BUILDER_TRACE
+      _trace(trace_op::copy_construct, trace_source::builder, std::addressof(other));
+#endif
     }
 
     /// @brief Move constructor.
+    ///
+    /// The owned string buffer is taken over, its address doesn't change.
     /// @param other  `c_str::basic_builder` object to be moved.
-    constexpr basic_builder(basic_builder &&other) noexcept(std::is_nothrow_default_constructible_v<_allocator_type> &&
-                                                            (std::allocator_traits<_allocator_type>::propagate_on_container_move_assignment::value ||
-                                                             std::allocator_traits<_allocator_type>::is_always_equal::value))
+    constexpr basic_builder(basic_builder &&other) noexcept :
+      _m_zero_suffixed{ std::move(other._m_zero_suffixed) },
+      _m_ptr{ std::exchange(other._m_ptr, other._get_ptr(nullptr)) }
     {
-      _move_used_member(std::forward<basic_builder>(other));
+      _take_cache(other);
+#ifdef C_STR_BUILDER_TRACE
+      _trace(trace_op::move_construct, trace_source::builder, std::addressof(other));
+#endif
     }
 
     /// @brief Copy assignment operator.
@@ -283,7 +1238,12 @@ namespace c_str
     constexpr basic_builder &operator=(const basic_builder &other)
     {
       if (this != std::addressof(other))
+      {
         _copy_used_member(other);
+#ifdef C_STR_BUILDER_TRACE
+        _trace(trace_op::copy_assign, trace_source::builder, std::addressof(other));
+#endif
+      }
 
       return *this;
     }
@@ -295,13 +1255,97 @@ namespace c_str
                                                                         std::allocator_traits<_allocator_type>::is_always_equal::value))
     {
       if (this != std::addressof(other))
+      {
         _move_used_member(std::forward<basic_builder>(other));
+#ifdef C_STR_BUILDER_TRACE
+        _trace(trace_op::move_assign, trace_source::builder, std::addressof(other));
+#endif
+      }
 
       return *this;
     }
 
+#ifdef C_STR_BUILDER_TRACE
+    /// @brief Destructor reporting the end of the lifetime in the capture
+    ///        mode, see @ref Trace.
+    constexpr ~basic_builder()
+    {
+      _trace(trace_op::destroy, trace_source::builder, nullptr);
+    }
+#else
     /// @brief Explicit default destructor.
     constexpr ~basic_builder() = default;
+#endif
+
+    /// @brief The `c_str::basic_builder::for_overwrite()` static member
+    ///        function creates a `c_str::basic_builder` object whose C-string
+    ///        is written directly into the owned string buffer.
+    ///
+    /// This avoids creating the string somewhere else first and copying it
+    /// afterwards, e.g. for decoded or formatted strings. The terminating null
+    /// and the padding (see @ref Padding) are appended after `writer`
+    /// returned. If `writer` writes no characters, the object provides a
+    /// zero-length string like it was constructed from an empty sequence.
+    /// @tparam WriterT  Type of the function object writing the characters.
+    /// @param maxCount  Maximum number of characters to be written.
+    /// @param writer    Function object receiving a pointer to the
+    ///                  uninitialized buffer of `maxCount` characters. It
+    ///                  returns the number of characters actually written.
+    /// @return `c_str::basic_builder` object owning the written C-string.
+    template<class WriterT>
+    static constexpr basic_builder for_overwrite(const size_type maxCount, WriterT writer)
+      requires std::is_invocable_r_v<size_type, WriterT &, value_type *>
+    {
+      basic_builder csb{};
+      csb._m_zero_suffixed.resize_and_overwrite(maxCount + _padding, [&writer](value_type *const buf, const size_type) {
+        const auto count{ static_cast<size_type>(writer(buf)) };
+        if constexpr (_padding != 0)
+          _traits_type::assign(buf + count, _padding, value_type{});
+
+        return count + _padding;
+      });
+      if (csb._m_zero_suffixed.size() == _padding) // zero-size result => zero-length C string
+      {
+        csb._m_zero_suffixed = {};
+        csb._m_ptr = std::addressof(_m_zero);
+      }
+      else
+        csb._m_ptr = nullptr; // provided by `_m_zero_suffixed`
+
+#ifdef C_STR_BUILDER_TRACE
+      csb._trace(trace_op::overwrite, trace_source::written, nullptr);
+#endif
+      return csb;
+    }
+
+    /// @brief The `c_str::basic_builder::adopt()` static member function
+    ///        creates a `c_str::basic_builder` object that takes over the
+    ///        buffer of a string without copying the characters.
+    ///
+    /// The padding (see @ref Padding) is appended, which doesn't reallocate if
+    /// the capacity of the string is sufficient. An empty string results in a
+    /// zero-length string like an empty sequence.
+    /// @param str  String to be moved into the owned string buffer.
+    /// @return `c_str::basic_builder` object owning the C-string.
+    static constexpr basic_builder adopt(string_type &&str)
+    {
+      basic_builder csb{};
+      if (str.empty())
+      {
+        csb._m_ptr = std::addressof(_m_zero);
+        return csb;
+      }
+
+      csb._m_zero_suffixed = std::move(str);
+      if constexpr (_padding != 0)
+        csb._m_zero_suffixed.append(_padding, value_type{});
+
+      csb._m_ptr = nullptr; // provided by `_m_zero_suffixed`
+#ifdef C_STR_BUILDER_TRACE
+      csb._trace(trace_op::overwrite, trace_source::written, nullptr);
+#endif
+      return csb;
+    }
 
     /// @brief The `c_str::basic_builder::get()` member function provides a
     ///        pointer to the string buffer object, or a null pointer.
@@ -310,7 +1354,7 @@ namespace c_str
     ///         template parameter.
     constexpr const_pointer get() const noexcept
     {
-      return _m_ptr;
+      return _m_zero_suffixed.empty() ? _m_ptr : _m_zero_suffixed.data();
     }
 
     /// @brief The `c_str::basic_builder::length()` member function provides the
@@ -321,55 +1365,313 @@ namespace c_str
     /// The null character is the sentinel where processing of the character
     /// sequence stops if the C-string pointer is passed to C functions. It is
     /// not necessarily the last character in the underlying string buffer. <br>
-    /// Note: The length is determined every time new because the class does not
-    /// maintain it for successive function calls.
+    /// Note: The length is determined with the first call (also by `view()`,
+    /// comparisons, or `hash()`) and cached for successive calls, which may
+    /// happen concurrently. Thus, a C-string which is not owned must not be
+    /// modified as long as the object refers to it.
     /// @return String length of the used part of the character sequence, or 0
     ///         for a null pointer.
     constexpr size_type length() const
     {
+      if (std::is_constant_evaluated())
+        return _find_length();
+
+      if (const auto cached{ std::atomic_ref<size_type>{ _m_length }.load(std::memory_order_relaxed) }; cached != _m_unknown)
+        return cached & ~_m_hashed;
+
+      const auto len{ _find_length() };
+      auto expected{ _m_unknown };
+      std::atomic_ref<size_type>{ _m_length }.compare_exchange_strong(expected, len, std::memory_order_relaxed); // keeps a hash value cached by another thread in the meantime
+      return len;
+    }
+
+    /// @brief The `c_str::basic_builder::hash()` member function provides the
+    ///        hash value of the C-string.
+    ///
+    /// The value equals that of `std::hash<std::basic_string_view<CharT>>` for
+    /// `view()`. It is computed with the first call and cached along with the
+    /// length, so repeated lookups of the object in unordered containers
+    /// neither search the terminating null nor hash the characters again.
+    /// @return Hash value of the C-string, that of a zero-length string for a
+    ///         null pointer.
+    std::size_t hash() const noexcept;
+
+
+    /// @brief The `c_str::basic_builder::begin()` member function provides an
+    ///        iterator to the first character of the C-string.
+    ///
+    /// Along with `end()`, the object is a range of the characters up to the
+    /// terminating null, so range algorithms can process the C-string in a
+    /// single pass without determining its length first.
+    /// @return Pointer to the first character, or to a zero-length string if
+    ///         the provided pointer is null.
+    constexpr const_pointer begin() const noexcept
+    {
+      const auto ptr{ get() };
       if constexpr (null_behavior == if_null::make_zero_length)
-        return _traits_type::length(_m_ptr);
+        return ptr;
       else
-        return _m_ptr ? _traits_type::length(_m_ptr) : size_type{};
+        return ptr ? ptr : std::addressof(_m_zero);
+    }
+
+    /// @brief The `c_str::basic_builder::end()` member function provides the
+    ///        sentinel denoting the terminating null of the C-string.
+    /// @return `c_str::null_sentinel`
+    constexpr null_sentinel_t end() const noexcept
+    {
+      return null_sentinel;
+    }
+
+    /// @brief The `c_str::basic_builder::is_owning()` member function checks
+    ///        whether the C-string is a copy held by this object.
+    /// @return `true` if the provided pointer refers to the owned string
+    ///         buffer, `false` if it refers to the original string-like object,
+    ///         a shared zero-length string, or is a null pointer.
+    constexpr bool is_owning() const noexcept
+    {
+      return !_m_zero_suffixed.empty();
+    }
+
+    /// @brief The `c_str::basic_builder::owned_bytes()` member function
+    ///        provides the size of the owned string buffer.
+    ///
+    /// The size includes the terminating null and any padding (see
+    /// @ref Padding).
+    /// @return Number of bytes of the allocated string buffer, or 0 if nothing
+    ///         is allocated because the object does not own the C-string or
+    ///         keeps it in the small-string buffer.
+    constexpr size_type owned_bytes() const noexcept
+    {
+      return _m_zero_suffixed.is_local() ? size_type{} : (_m_zero_suffixed.capacity() + 1) * sizeof(value_type);
+    }
+
+    /// @brief The `c_str::basic_builder::view()` member function provides a
+    ///        `std::basic_string_view` of the C-string.
+    /// @return String view from the beginning of the sequence to the first
+    ///         occurrence of a null character, or an empty string view for a
+    ///         null pointer.
+    constexpr std::basic_string_view<value_type> view() const noexcept
+    {
+      return { begin(), length() };
+    }
+
+    /// @brief Equality operator comparing the C-strings of two
+    ///        `c_str::basic_builder` objects. A null pointer compares equal to
+    ///        a zero-length string.
+    friend constexpr bool operator==(const basic_builder &lhs, const basic_builder &rhs) noexcept
+    {
+      return lhs.get() == rhs.get() || lhs.view() == rhs.view();
+    }
+
+    /// @brief Equality operator comparing the C-string of a
+    ///        `c_str::basic_builder` object with a string view, or an object
+    ///        convertible to it (like a string literal or `std::basic_string`).
+    ///        A null pointer compares equal to a zero-length string.
+    template<class StrT>
+    friend constexpr bool operator==(const basic_builder &lhs, const StrT &rhs) noexcept
+      requires _comparable_string<StrT>
+    {
+      return lhs.view() == _view_of(rhs);
+    }
+
+    /// @brief Three-way comparison operator comparing the C-strings of two
+    ///        `c_str::basic_builder` objects lexicographically.
+    friend constexpr auto operator<=>(const basic_builder &lhs, const basic_builder &rhs) noexcept
+    {
+      return lhs.view() <=> rhs.view();
+    }
+
+    /// @brief Three-way comparison operator comparing the C-string of a
+    ///        `c_str::basic_builder` object with a string view, or an object
+    ///        convertible to it, lexicographically.
+    template<class StrT>
+    friend constexpr auto operator<=>(const basic_builder &lhs, const StrT &rhs) noexcept
+      requires _comparable_string<StrT>
+    {
+      return lhs.view() <=> _view_of(rhs);
     }
 
+    /// @brief The `c_str::basic_builder::has_safe_padding()` member function
+    ///        checks whether at least `bytes` bytes following the terminating
+    ///        null of the C-string can be read.
+    ///
+    /// An owned string buffer is followed by `padding_bytes` zero bytes. Beyond
+    /// that, and for a buffer which is not owned, the bytes can be read if they
+    /// don't cross a 4 KiB boundary behind the terminating null, as memory is
+    /// protected at page granularity. 4 KiB is the smallest page size of the
+    /// supported platforms, and larger pages are multiples of it, so the check
+    /// is conservative. Their values are unspecified in this case, and memory
+    /// checkers (like AddressSanitizer) report such reads.
+    /// @param bytes  Number of bytes behind the terminating null required to be
+    ///               readable.
+    /// @return `true` if the bytes can be read, `false` otherwise or for a null
+    ///         pointer.
+    bool has_safe_padding(size_type bytes) const noexcept;
+
+
+    /// @brief The `c_str::basic_builder::is_aligned()` member function checks
+    ///        whether the provided pointer is aligned to a multiple of
+    ///        `alignment` bytes.
+    /// @param alignment  Required alignment, a power of 2.
+    /// @return `true` if the pointer is aligned, `false` otherwise or for a
+    ///         null pointer.
+    bool is_aligned(const size_type alignment) const noexcept
+    {
+      const auto ptr{ get() };
+      return ptr && !(reinterpret_cast<std::uintptr_t>(ptr) & (alignment - 1));
+    }
+
+
     /// @brief The `c_str::basic_builder::swap()` member function exchanges the
     ///        contents of this `c_str::basic_builder` object with those of
     ///        `other`.
     /// @param other  The `c_str::basic_builder` object to exchange the contents
     ///               with.
-    constexpr void swap(basic_builder &other) noexcept(std::allocator_traits<_allocator_type>::propagate_on_container_swap::value ||
-                                                       std::allocator_traits<_allocator_type>::is_always_equal::value)
+    constexpr void swap(basic_builder &other) noexcept
     {
       if (this == std::addressof(other))
         return;
 
-      const auto thisBufUsed{ _m_zero_suffixed.c_str() == _m_ptr };
-      const auto otherBufUsed{ other._m_zero_suffixed.c_str() == other._m_ptr };
-      if (!thisBufUsed && !otherBufUsed)
+#ifdef C_STR_BUILDER_TRACE
+      _trace(trace_op::swap, trace_source::builder, std::addressof(other));
+#endif
+      _m_zero_suffixed.swap(other._m_zero_suffixed); // allocated string buffers keep their addresses
+      std::swap(_m_ptr, other._m_ptr);
+      if (!std::is_constant_evaluated()) // nothing is cached during constant evaluation
       {
-        std::swap(_m_ptr, other._m_ptr);
-        return;
+        std::swap(_m_length, other._m_length);
+        std::swap(_m_hash, other._m_hash);
       }
+    }
+  };
 
-      _m_zero_suffixed.swap(other._m_zero_suffixed);
-      if (thisBufUsed && otherBufUsed)
-      {
-        _m_ptr = _m_zero_suffixed.c_str();
-        other._m_ptr = other._m_zero_suffixed.c_str();
-      }
-      else if (thisBufUsed)
-      {
-        _m_ptr = std::move(other._m_ptr);
-        other._m_ptr = other._m_zero_suffixed.c_str();
-      }
-      else // otherBufUsed
+  /// @cond _NO_DOC_
+  // the non-constexpr member functions are defined out of line and not inline, so an explicit instantiation declaration suppresses their instantiation, see @ref Instantiation
+#if C_STR_LARGE_COPY_THRESHOLD > 0
+  template<common_char_type CharT, if_null NullBehavior, class AllocatorT>
+  void basic_builder<CharT, NullBehavior, AllocatorT>::_advise_huge_pages([[maybe_unused]] void *const buf, [[maybe_unused]] const std::size_t bytes) noexcept
+  {
+#  if defined(__linux__) && defined(MADV_HUGEPAGE)
+    static constexpr std::uintptr_t pageSize{ 4096 };
+    const auto first{ (reinterpret_cast<std::uintptr_t>(buf) + pageSize - 1) & ~(pageSize - 1) };
+    const auto last{ (reinterpret_cast<std::uintptr_t>(buf) + bytes) & ~(pageSize - 1) };
+    if (last > first)
+      static_cast<void>(::madvise(reinterpret_cast<void *>(first), last - first, MADV_HUGEPAGE)); // only a hint, failing is not an error
+#  endif
+  }
+
+  template<common_char_type CharT, if_null NullBehavior, class AllocatorT>
+  void basic_builder<CharT, NullBehavior, AllocatorT>::_stream_copy(void *const dest, const void *const src, std::size_t bytes) noexcept
+  {
+#  if defined(C_STR_STREAMING_STORES_)
+    auto destIt{ static_cast<unsigned char *>(dest) };
+    auto srcIt{ static_cast<const unsigned char *>(src) };
+    const auto misalignment{ static_cast<std::size_t>((16U - (reinterpret_cast<std::uintptr_t>(destIt) & 15U)) & 15U) }; // streaming stores require 16-byte aligned destinations
+    const auto head{ misalignment < bytes ? misalignment : bytes };
+    std::memcpy(destIt, srcIt, head);
+    destIt += head;
+    srcIt += head;
+    bytes -= head;
+    for (; bytes >= 64U; bytes -= 64U, destIt += 64U, srcIt += 64U)
+    {
+      const auto chunk0{ _mm_loadu_si128(reinterpret_cast<const __m128i *>(srcIt)) };
+      const auto chunk1{ _mm_loadu_si128(reinterpret_cast<const __m128i *>(srcIt + 16)) };
+      const auto chunk2{ _mm_loadu_si128(reinterpret_cast<const __m128i *>(srcIt + 32)) };
+      const auto chunk3{ _mm_loadu_si128(reinterpret_cast<const __m128i *>(srcIt + 48)) };
+      _mm_stream_si128(reinterpret_cast<__m128i *>(destIt), chunk0);
+      _mm_stream_si128(reinterpret_cast<__m128i *>(destIt + 16), chunk1);
+      _mm_stream_si128(reinterpret_cast<__m128i *>(destIt + 32), chunk2);
+      _mm_stream_si128(reinterpret_cast<__m128i *>(destIt + 48), chunk3);
+    }
+
+    std::memcpy(destIt, srcIt, bytes);
+    _mm_sfence(); // make the streamed data visible before the buffer is used
+#  else
+    std::memcpy(dest, src, bytes);
+#  endif
+  }
+
+  template<common_char_type CharT, if_null NullBehavior, class AllocatorT>
+  void basic_builder<CharT, NullBehavior, AllocatorT>::_large_copy(value_type *const dest, const value_type *const src, const size_type count)
+  {
+    const auto bytes{ count * sizeof(value_type) };
+    _advise_huge_pages(dest, bytes);
+#  if C_STR_LARGE_COPY_THREADS > 1
+    if (bytes >= C_STR_PARALLEL_COPY_THRESHOLD)
+    {
+      static constexpr std::size_t threadCount{ C_STR_LARGE_COPY_THREADS };
+      const auto chunkSize{ (bytes / threadCount + 63U) & ~std::size_t{ 63 } }; // cache-line granular chunks
+      const auto destBytes{ reinterpret_cast<unsigned char *>(dest) };
+      const auto srcBytes{ reinterpret_cast<const unsigned char *>(src) };
       {
-        other._m_ptr = std::move(_m_ptr);
-        _m_ptr = _m_zero_suffixed.c_str();
-      }
+        std::jthread workers[threadCount - 1]{};
+        for (std::size_t idx{ 1 }; idx < threadCount && idx * chunkSize < bytes; ++idx)
+        {
+          const auto offset{ idx * chunkSize };
+          workers[idx - 1] = std::jthread{ _stream_copy, destBytes + offset, srcBytes + offset, chunkSize < bytes - offset ? chunkSize : bytes - offset };
+        }
+
+        _stream_copy(destBytes, srcBytes, chunkSize < bytes ? chunkSize : bytes);
+      } // the workers are joined here
+
+      return;
     }
+#  endif
+    _stream_copy(dest, src, bytes);
+  }
+
+  template<common_char_type CharT, if_null NullBehavior, class AllocatorT>
+  void basic_builder<CharT, NullBehavior, AllocatorT>::_assign_large(const value_type *const src, const size_type count)
+  {
+    _m_zero_suffixed.clear();
+    _append_for_overwrite(count + _padding, [src, count](value_type *const dest) {
+      _large_copy(dest, src, count);
+      if constexpr (_padding != 0)
+        _traits_type::assign(dest + count, _padding, value_type{});
+    });
+  }
+#endif
+
+  template<common_char_type CharT, if_null NullBehavior, class AllocatorT>
+  std::size_t basic_builder<CharT, NullBehavior, AllocatorT>::hash() const noexcept
+  {
+    const std::atomic_ref<size_type> state{ _m_length };
+    if (const auto cached{ state.load(std::memory_order_acquire) }; cached != _m_unknown && (cached & _m_hashed))
+      return std::atomic_ref<std::size_t>{ _m_hash }.load(std::memory_order_relaxed);
+
+    const auto len{ length() };
+    const auto value{ std::hash<std::basic_string_view<value_type>>{}(std::basic_string_view<value_type>{ begin(), len }) };
+    std::atomic_ref<std::size_t>{ _m_hash }.store(value, std::memory_order_relaxed);
+    state.store(len | _m_hashed, std::memory_order_release); // publishes the hash value
+    return value;
+  }
+
+  template<common_char_type CharT, if_null NullBehavior, class AllocatorT>
+  bool basic_builder<CharT, NullBehavior, AllocatorT>::has_safe_padding(const size_type bytes) const noexcept
+  {
+    const auto ptr{ get() };
+    if (!ptr)
+      return false;
+
+    const auto owned{ is_owning() };
+    if (owned && bytes <= padding_bytes)
+      return true;
+
+    static constexpr std::uintptr_t pageSize{ 4096 }; // smallest page size of the supported platforms
+    const auto end{ reinterpret_cast<std::uintptr_t>(ptr + length() + 1) }; // first byte behind the terminating null
+    return ((end - 1) & (pageSize - 1)) + bytes < pageSize;
+  }
+  /// @endcond
+
+
+#ifndef C_STR_BUILDER_TRACE // traced objects are relocated using the move constructor and destructor, which report the new address
+  /// @cond _NO_DOC_
+  template<common_char_type CharT, if_null NullBehavior, class AllocatorT>
+  struct is_trivially_relocatable<basic_builder<CharT, NullBehavior, AllocatorT>> : is_trivially_relocatable<basic_owned_buffer<CharT, AllocatorT>>
+  {
   };
+  /// @endcond
+#endif
 
   /// @relates c_str::basic_builder
   /// @brief Deduction guide for a buffer of `char` elements.
@@ -416,8 +1718,123 @@ namespace c_str
   ///        `c_str::basic_builder<char32_t>`.
   typedef basic_builder<char32_t> u32builder;
 
+  /// @brief Transparent hash function object for `c_str::basic_builder`
+  ///        objects and other strings of `CharT` elements.
+  ///
+  /// Using it along with `c_str::transparent_equal_to` in an unordered
+  /// container keyed by `c_str::basic_builder`, lookups can be performed using
+  /// a `std::basic_string_view`, a `std::basic_string`, or a pointer to a
+  /// C-string without constructing a `c_str::basic_builder` first. The hash
+  /// value is the same as that of `std::hash<std::basic_string_view<CharT>>`.
+  /// <br>
+  /// Note: Since the function object is `noexcept`, libstdc++ doesn't store
+  /// the hash values along with the keys, and hashes stored keys again while
+  /// walking a bucket. `c_str::basic_builder` keys provide their cached hash
+  /// value (see `c_str::basic_builder::hash()`), so this doesn't touch their
+  /// characters.
+  /// @tparam CharT  Value type of the characters.
+  template<common_char_type CharT = char>
+  struct transparent_hash
+  {
+    /// @brief Marks the function object as transparent for heterogeneous
+    ///        lookup.
+    using is_transparent = void;
+
+    /// @brief Compute the hash value of a string.
+    /// @param str  A `c_str::basic_builder`, or an object convertible to
+    ///             `std::basic_string_view<CharT>`.
+    /// @return Hash value of the string.
+    template<class StrT>
+    constexpr std::size_t operator()(const StrT &str) const noexcept
+    {
+      if constexpr (requires { { str.hash() } -> std::same_as<std::size_t>; })
+        return str.hash();
+      else
+        return std::hash<std::basic_string_view<CharT>>{}(_view_of(str));
+    }
+
+    /// @cond _NO_DOC_
+    template<class StrT>
+    static constexpr std::basic_string_view<CharT> _view_of(const StrT &str) noexcept
+    {
+      if constexpr (requires { { str.view() } -> std::same_as<std::basic_string_view<CharT>>; })
+        return str.view();
+      else if constexpr (std::is_pointer_v<StrT> || std::is_null_pointer_v<StrT>)
+        return str ? std::basic_string_view<CharT>{ str } : std::basic_string_view<CharT>{};
+      else
+        return std::basic_string_view<CharT>{ str };
+    }
+    /// @endcond
+  };
+
+  /// @brief Transparent equality function object for `c_str::basic_builder`
+  ///        objects and other strings of `CharT` elements. See
+  ///        `c_str::transparent_hash`.
+  /// @tparam CharT  Value type of the characters.
+  template<common_char_type CharT = char>
+  struct transparent_equal_to
+  {
+    /// @brief Marks the function object as transparent for heterogeneous
+    ///        lookup.
+    using is_transparent = void;
+
+    /// @brief Compare two strings for equality.
+    /// @param lhs  A `c_str::basic_builder`, or an object convertible to
+    ///             `std::basic_string_view<CharT>`.
+    /// @param rhs  A `c_str::basic_builder`, or an object convertible to
+    ///             `std::basic_string_view<CharT>`.
+    /// @return `true` if the strings are equal.
+    template<class LhsT, class RhsT>
+    constexpr bool operator()(const LhsT &lhs, const RhsT &rhs) const noexcept
+    {
+      return transparent_hash<CharT>::_view_of(lhs) == transparent_hash<CharT>::_view_of(rhs);
+    }
+  };
+
 } // namespace c_str
 
+/// @cond _NO_DOC_
+template<c_str::common_char_type CharT, c_str::if_null NullBehavior, class AllocatorT>
+struct std::hash<c_str::basic_builder<CharT, NullBehavior, AllocatorT>>
+{
+  std::size_t operator()(const c_str::basic_builder<CharT, NullBehavior, AllocatorT> &csb) const noexcept
+  {
+    return csb.hash();
+  }
+};
+/// @endcond
+
+#if defined(C_STR_BUILDER_EXTERN_TEMPLATES) || defined(C_STR_BUILDER_INSTANTIATE_TEMPLATES)
+/// @cond _NO_DOC_
+#  ifdef C_STR_BUILDER_INSTANTIATE_TEMPLATES
+#    define C_STR_BUILDER_TEMPLATE_ template
+#  else
+#    define C_STR_BUILDER_TEMPLATE_ extern template
+#  endif
+// explicit instantiations of the type definitions above for both `if_null` values, including the constructors from the most common sources, see @ref Instantiation
+#  define C_STR_BUILDER_INSTANTIATE_(CharT, NullBehavior)                                                                             \
+    C_STR_BUILDER_TEMPLATE_ class c_str::basic_builder<CharT, c_str::if_null::NullBehavior>;                                        \
+    C_STR_BUILDER_TEMPLATE_ c_str::basic_builder<CharT, c_str::if_null::NullBehavior>::basic_builder(const CharT *const &);        \
+    C_STR_BUILDER_TEMPLATE_ c_str::basic_builder<CharT, c_str::if_null::NullBehavior>::basic_builder(const std::basic_string<CharT> &); \
+    C_STR_BUILDER_TEMPLATE_ c_str::basic_builder<CharT, c_str::if_null::NullBehavior>::basic_builder(const std::basic_string_view<CharT> &)
+C_STR_BUILDER_INSTANTIATE_(char, make_zero_length);
+C_STR_BUILDER_INSTANTIATE_(char, keep_null_pointer);
+C_STR_BUILDER_INSTANTIATE_(wchar_t, make_zero_length);
+C_STR_BUILDER_INSTANTIATE_(wchar_t, keep_null_pointer);
+C_STR_BUILDER_INSTANTIATE_(char8_t, make_zero_length);
+C_STR_BUILDER_INSTANTIATE_(char8_t, keep_null_pointer);
+C_STR_BUILDER_INSTANTIATE_(char16_t, make_zero_length);
+C_STR_BUILDER_INSTANTIATE_(char16_t, keep_null_pointer);
+C_STR_BUILDER_INSTANTIATE_(char32_t, make_zero_length);
+C_STR_BUILDER_INSTANTIATE_(char32_t, keep_null_pointer);
+#  undef C_STR_BUILDER_INSTANTIATE_
+#  undef C_STR_BUILDER_TEMPLATE_
+/// @endcond
+#endif
+
+#undef C_STR_NO_UNIQUE_ADDRESS_
+#undef C_STR_COLD_
+
 #if defined(__clang__)
 #  pragma clang diagnostic pop
 #elif defined(_MSC_VER)
@@ -0,0 +1,60 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str_builder_ref.h
+/// @brief     Fixed-layout reference to a C-string passed across a C ABI,
+///            optionally transferring the ownership of the string buffer.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C99, or C++.
+
+#ifndef C_STR_BUILDER_REF_H_6E2B7D41_0C9A_4F85_B3E6_59A1D8C4F270_1_0
+/// @cond _NO_DOC_
+#define C_STR_BUILDER_REF_H_6E2B7D41_0C9A_4F85_B3E6_59A1D8C4F270_1_0
+/// @endcond
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /// @brief The `c_str_builder_ref` structure refers to a null-terminated
+  ///        string, and owns it if `release` is not null.
+  ///
+  /// The producer fills the structure (in C++ using `c_str::builder_ref`). The
+  /// consumer reads the string, and calls `c_str_builder_ref_release()` once
+  /// it doesn't need the string anymore. The string buffer is then released
+  /// by the module that allocated it, using the `release` callback. If
+  /// `release` is null, the string is only borrowed, and it's up to the
+  /// interface contract how long it remains valid.
+  typedef struct c_str_builder_ref
+  {
+    const void *ptr; ///< pointer to the null-terminated string of `char_size`-byte characters, or null
+    size_t length; ///< number of characters, without the terminating null
+    void *token; ///< ownership token passed to `release`
+    void (*release)(void *token); ///< function releasing the string, or null if it isn't owned
+    size_t char_size; ///< size of a character in bytes (1, 2, or 4)
+  } c_str_builder_ref;
+
+  /// @brief The `c_str_builder_ref_release()` function releases the string
+  ///        if it is owned, and resets the structure.
+  /// @param ref  Pointer to the structure.
+  static inline void c_str_builder_ref_release(c_str_builder_ref *const ref)
+  {
+    if (ref->release)
+      ref->release(ref->token);
+
+    ref->ptr = NULL;
+    ref->length = 0;
+    ref->token = NULL;
+    ref->release = NULL;
+  }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
@@ -0,0 +1,221 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str_builder_ref.hpp
+/// @brief     Non-template handle of a `c_str::basic_builder` C-string for
+///            interfaces across shared-library boundaries.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C++20.
+
+#ifndef C_STR_BUILDER_REF_HPP_A47F1C93_2B5D_4E08_96C1_7D3E8F0A5B62_1_0
+/// @cond _NO_DOC_
+#define C_STR_BUILDER_REF_HPP_A47F1C93_2B5D_4E08_96C1_7D3E8F0A5B62_1_0
+/// @endcond
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "c_str_builder.hpp"
+#include "c_str_builder_ref.h"
+
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wc++98-compat" // C++20 is required anyway
+#elif defined(_MSC_VER)
+#  pragma warning(push)
+#  pragma warning(disable : 4710 4711) // functions may or may not be inlined
+#endif
+
+namespace c_str
+{
+
+  /// @brief The `c_str::builder_ref` class is a non-template, move-only owner
+  ///        of a `c_str_builder_ref` structure (see c_str_builder_ref.h).
+  ///
+  /// A `c_str::basic_builder` object owning its C-string converts to it
+  /// without copying the characters. The builder is moved to the heap, where
+  /// its C-string stays in place until the `release` callback deletes it
+  /// again. Since the callback is a function of the module that created the
+  /// builder, the buffer is always deallocated by the allocator that allocated
+  /// it. A builder referring to a string it doesn't own, e.g. a temporary
+  /// `std::string`, is copied into an owned buffer first. Use `borrow()` to
+  /// refer to a string that outlives the use of the reference. <br>
+  /// The structure is handed over to C code or another module using
+  /// `release()`, and taken over from there by the constructor taking a
+  /// `c_str_builder_ref`.
+  /// @code
+  ///   // plugin
+  ///   extern "C" c_str_builder_ref plugin_name() { return c_str::builder_ref{ c_str::builder{ make_name() } }.release(); } // the returned std::string is copied once
+  ///   extern "C" c_str_builder_ref plugin_version() { return c_str::builder_ref::borrow(c_str::builder{ "1.0" }).release(); } // a literal is never released
+  ///   // host
+  ///   const c_str::builder_ref name{ plugin_name() };
+  ///   std::puts(name.get<char>());
+  /// @endcode
+  class builder_ref
+  {
+  public:
+    /// @brief Type of lengths and sizes.
+    using size_type = std::size_t;
+
+  private:
+    c_str_builder_ref _m_ref{};
+
+    template<class BuilderT>
+    static void _release(void *const token) noexcept
+    {
+      delete static_cast<BuilderT *>(token);
+    }
+
+  public:
+    /// @brief Default constructor that creates an object referring to no
+    ///        string.
+    builder_ref() noexcept = default;
+
+    /// @brief Takes over a `c_str_builder_ref` structure, e.g. received
+    ///        from another module.
+    /// @param ref  Structure whose string is released by this object.
+    explicit builder_ref(const c_str_builder_ref &ref) noexcept :
+      _m_ref{ ref }
+    {
+    }
+
+    /// @brief Takes over the C-string of a `c_str::basic_builder` object.
+    ///        It is only copied if the builder doesn't own it.
+    /// @param csb  `c_str::basic_builder` object, which is moved.
+    template<common_char_type CharT, if_null NullBehavior, class AllocatorT>
+    builder_ref(basic_builder<CharT, NullBehavior, AllocatorT> &&csb)
+    {
+      using builder_type = basic_builder<CharT, NullBehavior, AllocatorT>;
+      _m_ref.char_size = sizeof(CharT);
+      _m_ref.length = csb.length();
+      if (!csb.is_owning() && csb.get()) // the referred string may expire with the builder, e.g. a temporary string
+        csb = builder_type::for_overwrite(_m_ref.length, [&csb](CharT *const dest) noexcept {
+          std::char_traits<CharT>::copy(dest, csb.get(), csb.length());
+          return csb.length();
+        });
+
+      if (!csb.is_owning()) // a null pointer, or the static zero-length string of the builder
+      {
+        _m_ref.ptr = csb.get();
+        return;
+      }
+
+      const auto owner{ new builder_type{ std::move(csb) } }; // an allocated buffer keeps its address, a small-string buffer moves along with the builder
+      _m_ref.ptr = owner->get();
+      _m_ref.token = owner;
+      _m_ref.release = _release<builder_type>;
+    }
+
+    /// @brief Refers to the C-string of a `c_str::basic_builder` object
+    ///        without taking it over. The C-string must outlive the use of the
+    ///        reference.
+    /// @param csb  `c_str::basic_builder` object.
+    /// @return `c_str::builder_ref` object borrowing the C-string.
+    template<common_char_type CharT, if_null NullBehavior, class AllocatorT>
+    static builder_ref borrow(const basic_builder<CharT, NullBehavior, AllocatorT> &csb) noexcept
+    {
+      builder_ref ref{};
+      ref._m_ref.ptr = csb.get();
+      ref._m_ref.length = csb.length();
+      ref._m_ref.char_size = sizeof(CharT);
+      return ref;
+    }
+
+    builder_ref(const builder_ref &) = delete;
+    builder_ref &operator=(const builder_ref &) = delete;
+
+    /// @brief Move constructor.
+    builder_ref(builder_ref &&other) noexcept :
+      _m_ref{ std::exchange(other._m_ref, c_str_builder_ref{}) }
+    {
+    }
+
+    /// @brief Move assignment operator.
+    builder_ref &operator=(builder_ref &&other) noexcept
+    {
+      if (this != std::addressof(other))
+      {
+        c_str_builder_ref_release(std::addressof(_m_ref));
+        _m_ref = std::exchange(other._m_ref, c_str_builder_ref{});
+      }
+
+      return *this;
+    }
+
+    /// @brief Destructor, releases the string if it is owned.
+    ~builder_ref()
+    {
+      c_str_builder_ref_release(std::addressof(_m_ref));
+    }
+
+    /// @brief Hands the structure over, e.g. to C code or another module,
+    ///        which becomes responsible for calling
+    ///        `c_str_builder_ref_release()`.
+    /// @return The `c_str_builder_ref` structure.
+    c_str_builder_ref release() noexcept
+    {
+      return std::exchange(_m_ref, c_str_builder_ref{});
+    }
+
+    /// @brief Provides the `c_str_builder_ref` structure, which remains owned
+    ///        by this object.
+    const c_str_builder_ref &ref() const noexcept
+    {
+      return _m_ref;
+    }
+
+    /// @brief Provides the C-string.
+    /// @tparam CharT  Character type expected by the caller.
+    /// @return Pointer to the C-string, or a null pointer if the object
+    ///         refers to no string or the character size doesn't match.
+    template<common_char_type CharT>
+    const CharT *get() const noexcept
+    {
+      return _m_ref.char_size == sizeof(CharT) ? static_cast<const CharT *>(_m_ref.ptr) : nullptr;
+    }
+
+    /// @brief Provides a `std::basic_string_view` of the C-string.
+    /// @tparam CharT  Character type expected by the caller.
+    /// @return String view, empty if the object refers to no string or the
+    ///         character size doesn't match.
+    template<common_char_type CharT>
+    std::basic_string_view<CharT> view() const noexcept
+    {
+      const auto ptr{ get<CharT>() };
+      return ptr ? std::basic_string_view<CharT>{ ptr, _m_ref.length } : std::basic_string_view<CharT>{};
+    }
+
+    /// @brief Provides the number of characters.
+    size_type length() const noexcept
+    {
+      return _m_ref.length;
+    }
+
+    /// @brief Provides the size of a character in bytes, or 0 if the object
+    ///        has never referred to a string.
+    size_type char_size() const noexcept
+    {
+      return _m_ref.char_size;
+    }
+
+    /// @brief Checks whether the object owns the string.
+    bool is_owning() const noexcept
+    {
+      return _m_ref.release != nullptr;
+    }
+  };
+
+} // namespace c_str
+
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#elif defined(_MSC_VER)
+#  pragma warning(pop)
+#endif
+
+#endif // include guard
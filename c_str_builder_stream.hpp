@@ -0,0 +1,271 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str_builder_stream.hpp
+/// @brief     Stream buffer and output stream writing directly into the owned
+///            string buffer of a `c_str::basic_builder`.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C++20.
+
+#ifndef C_STR_BUILDER_STREAM_089C8A16_8194_4D2F_A8FE_839441D97831_1_0
+/// @cond _NO_DOC_
+#define C_STR_BUILDER_STREAM_089C8A16_8194_4D2F_A8FE_839441D97831_1_0
+/// @endcond
+
+#include <cstddef>
+#include <ios>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "c_str_builder.hpp"
+
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wc++98-compat" // C++20 is required anyway
+#elif defined(_MSC_VER)
+#  pragma warning(push)
+#  pragma warning(disable : 4710 4711) // functions may or may not be inlined
+#endif
+
+namespace c_str
+{
+
+  /// @brief The `c_str::basic_builder_streambuf` class template is a stream
+  ///        buffer that collects the output in a buffer which is finally
+  ///        taken over by a `c_str::basic_builder` object.
+  ///
+  /// Compared with a `std::basic_ostringstream` whose `str()` copies the
+  /// content, and a `c_str::basic_builder` which may copy it once again, the
+  /// characters are written only once. The buffer is a
+  /// `c_str::basic_owned_buffer`. Output is written into its small-string
+  /// buffer first, so short strings are never allocated. Once they don't fit,
+  /// the buffer is allocated with room for 64 characters (or the capacity
+  /// passed to the constructor) and grows geometrically. There is always room
+  /// for the terminating null behind the written characters.
+  /// @tparam CharT         Value type of the characters.
+  /// @tparam NullBehavior  Value of the `c_str::if_null` enumeration. See
+  ///                       @ref NullBehavior.
+  /// @tparam AllocatorT    Allocator type used to allocate the buffer.
+  template<common_char_type CharT, if_null NullBehavior = if_null::DEF_NULL_BEHAVIOR, class AllocatorT = std::allocator<CharT>>
+  class basic_builder_streambuf : public std::basic_streambuf<CharT>
+  {
+    using _base_type = std::basic_streambuf<CharT>;
+
+  public:
+    /// @brief Type of the `c_str::basic_builder` provided by `finish()`.
+    using builder_type = basic_builder<CharT, NullBehavior, AllocatorT>;
+
+    /// @brief Character type of the `CharT` template parameter.
+    using char_type = typename _base_type::char_type;
+
+    /// @brief Traits type of the characters.
+    using traits_type = typename _base_type::traits_type;
+
+    /// @brief Integral type to represent a character or the end of a file.
+    using int_type = typename _base_type::int_type;
+
+    /// @brief Type of sizes.
+    using size_type = std::size_t;
+
+  private:
+    static constexpr size_type _padding{ builder_type::padding_bytes / sizeof(char_type) }; // kept free behind the put area, so that `finish()` doesn't reallocate
+    static constexpr size_type _initial_capacity{ 64 };
+
+    typename builder_type::string_type _m_buf{};
+    size_type _m_capacity{ _initial_capacity + _padding }; // capacity of the first allocation, once the small-string buffer is exceeded
+
+    size_type _written() const noexcept
+    {
+      return static_cast<size_type>(this->pptr() - this->pbase()); // the put area begins at the beginning of the buffer, both are null as long as nothing is written
+    }
+
+    // advances the put pointer, `pbump()` takes only an `int`
+    void _advance(size_type count) noexcept
+    {
+      static constexpr size_type maxStep{ static_cast<size_type>(std::numeric_limits<int>::max()) };
+      for (; count > maxStep; count -= maxStep)
+        this->pbump(static_cast<int>(maxStep));
+
+      this->pbump(static_cast<int>(count));
+    }
+
+    // makes room for at least `count` more characters, the terminating null of the string buffer is always reserved beyond
+    void _grow(const size_type count)
+    {
+      const auto written{ _written() };
+      const auto required{ written + count + _padding };
+      auto capacity{ _m_buf.capacity() }; // the small-string buffer is used as long as it is sufficient
+      if (capacity < required)
+      {
+        capacity = capacity < _m_capacity ? _m_capacity : capacity + capacity;
+        while (capacity < required)
+          capacity += capacity;
+      }
+
+      _m_buf.reserve(capacity);
+      _m_buf.resize_and_overwrite(_m_buf.capacity(), [](char_type *const, const size_type bufSize) noexcept {
+        return bufSize; // the characters behind the written ones are overwritten anyway
+      });
+      this->setp(_m_buf.data(), _m_buf.data() + _m_buf.size() - _padding);
+      _advance(written);
+    }
+
+  protected:
+    /// @brief Writes a character if the buffer is full.
+    int_type overflow(const int_type ch) override
+    {
+      if (traits_type::eq_int_type(ch, traits_type::eof()))
+        return traits_type::not_eof(ch);
+
+      if (this->pptr() == this->epptr())
+        _grow(1);
+
+      *this->pptr() = traits_type::to_char_type(ch);
+      this->pbump(1);
+      return ch;
+    }
+
+    /// @brief Writes `count` characters as a whole.
+    std::streamsize xsputn(const char_type *const str, const std::streamsize count) override
+    {
+      if (count <= 0)
+        return 0;
+
+      const auto size{ static_cast<size_type>(count) };
+      if (static_cast<size_type>(this->epptr() - this->pptr()) < size)
+        _grow(size);
+
+      traits_type::copy(this->pptr(), str, size);
+      _advance(size);
+      return count;
+    }
+
+  public:
+    /// @brief Default constructor.
+    basic_builder_streambuf() noexcept = default;
+
+    /// @brief Create a stream buffer with a capacity of at least `capacity`
+    ///        characters, allocated with the first write that exceeds the
+    ///        small-string buffer.
+    explicit basic_builder_streambuf(const size_type capacity) noexcept :
+      _m_capacity{ capacity + _padding > _m_capacity ? capacity + _padding : _m_capacity }
+    {
+    }
+
+    basic_builder_streambuf(const basic_builder_streambuf &) = delete;
+    basic_builder_streambuf &operator=(const basic_builder_streambuf &) = delete;
+
+    /// @brief Provides a view of the characters written so far.
+    std::basic_string_view<char_type> view() const noexcept
+    {
+      return { this->pbase(), _written() };
+    }
+
+    /// @brief Hands the written characters over to a `c_str::basic_builder`
+    ///        object, and restarts with the empty small-string buffer.
+    /// @return `c_str::basic_builder` object owning the buffer with the
+    ///         written characters.
+    builder_type finish()
+    {
+      _m_buf.resize(_written()); // only shrinks, the buffer is kept
+      auto csb{ builder_type::adopt(std::move(_m_buf)) };
+      _m_buf = {};
+      this->setp(nullptr, nullptr);
+      return csb;
+    }
+  };
+
+  /// @brief The `c_str::basic_builder_ostream` class template is an output
+  ///        stream writing into a `c_str::basic_builder_streambuf`.
+  ///
+  /// Existing code formatting its output using `operator<<` can thus produce
+  /// a C-string in a single write pass:
+  /// @code
+  ///   c_str::builder_ostream stream{};
+  ///   stream << "id=" << id << ", value=" << value;
+  ///   const auto csb{ stream.finish() };
+  ///   c_function(csb.get());
+  /// @endcode
+  /// @tparam CharT         Value type of the characters.
+  /// @tparam NullBehavior  Value of the `c_str::if_null` enumeration. See
+  ///                       @ref NullBehavior.
+  /// @tparam AllocatorT    Allocator type used to allocate the buffer.
+  template<common_char_type CharT, if_null NullBehavior = if_null::DEF_NULL_BEHAVIOR, class AllocatorT = std::allocator<CharT>>
+  class basic_builder_ostream : public std::basic_ostream<CharT>
+  {
+  public:
+    /// @brief Type of the stream buffer.
+    using streambuf_type = basic_builder_streambuf<CharT, NullBehavior, AllocatorT>;
+
+    /// @brief Type of the `c_str::basic_builder` provided by `finish()`.
+    using builder_type = typename streambuf_type::builder_type;
+
+    /// @brief Type of sizes.
+    using size_type = std::size_t;
+
+  private:
+    streambuf_type _m_streambuf;
+
+  public:
+    /// @brief Default constructor.
+    basic_builder_ostream() :
+      std::basic_ostream<CharT>{ nullptr },
+      _m_streambuf{}
+    {
+      std::basic_ios<CharT>::rdbuf(std::addressof(_m_streambuf));
+    }
+
+    /// @brief Create a stream with a buffer capacity of at least `capacity`
+    ///        characters.
+    explicit basic_builder_ostream(const size_type capacity) :
+      std::basic_ostream<CharT>{ nullptr },
+      _m_streambuf{ capacity }
+    {
+      std::basic_ios<CharT>::rdbuf(std::addressof(_m_streambuf));
+    }
+
+    /// @brief Provides the stream buffer.
+    streambuf_type *rdbuf() const noexcept
+    {
+      return const_cast<streambuf_type *>(std::addressof(_m_streambuf));
+    }
+
+    /// @brief Provides a view of the characters written so far.
+    std::basic_string_view<CharT> view() const noexcept
+    {
+      return _m_streambuf.view();
+    }
+
+    /// @brief Hands the written characters over to a `c_str::basic_builder`
+    ///        object, and restarts with an empty buffer.
+    /// @return `c_str::basic_builder` object owning the buffer with the
+    ///         written characters.
+    builder_type finish()
+    {
+      return _m_streambuf.finish();
+    }
+  };
+
+  /// @brief `c_str::builder_ostream` is a type definition for
+  ///        `c_str::basic_builder_ostream<char>`.
+  typedef basic_builder_ostream<char> builder_ostream;
+
+  /// @brief `c_str::wbuilder_ostream` is a type definition for
+  ///        `c_str::basic_builder_ostream<wchar_t>`.
+  typedef basic_builder_ostream<wchar_t> wbuilder_ostream;
+
+} // namespace c_str
+
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#elif defined(_MSC_VER)
+#  pragma warning(pop)
+#endif
+
+#endif // include guard
@@ -0,0 +1,483 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str_dir_walker.hpp
+/// @brief     Recursive directory walker providing null-terminated paths from
+///            a reused path buffer.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C++20, and a POSIX system.
+
+#ifndef C_STR_DIR_WALKER_1F259BA6_0DD5_4127_87C8_FD37AF536B5D_1_0
+/// @cond _NO_DOC_
+#define C_STR_DIR_WALKER_1F259BA6_0DD5_4127_87C8_FD37AF536B5D_1_0
+/// @endcond
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "c_str_builder.hpp"
+
+#if !__has_include(<dirent.h>) || !__has_include(<fcntl.h>)
+#  error "c_str::dir_walker requires a POSIX system."
+#endif
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#  include <sys/syscall.h>
+#endif
+
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wc++98-compat" // C++20 is required anyway
+#endif
+
+namespace c_str
+{
+
+  /// @brief The `c_str::dir_walker` class walks a directory tree recursively
+  ///        and provides the null-terminated path of every entry.
+  ///
+  /// In contrast to `std::filesystem::recursive_directory_iterator`, which
+  /// creates a `std::filesystem::path` for every entry, the walker keeps a
+  /// single path buffer. The name of each entry is written in place behind
+  /// the path of its parent directory, followed by a terminating null. Thus,
+  /// walking a tree of millions of files needs only a handful of allocations
+  /// (the path buffer, and one read buffer per directory level). <br>
+  /// On Linux, directories are opened using `openat()` relative to their
+  /// parent and read in large batches using the `getdents64` system call.
+  /// Other POSIX systems use `fdopendir()` and `readdir()`. <br>
+  /// A `c_str::dir_walker::entry` provides a `c_str()` member function, so a
+  /// `c_str::builder` constructed from it refers to the path buffer without
+  /// copying. The entry is only valid until the walker advances.
+  ///
+  /// Entries are visited in pre-order, a directory before its content. Symbolic
+  /// links are reported but not followed, only the root may be a symbolic link
+  /// to a directory. Subdirectories that vanished or cannot be opened due to
+  /// missing permissions are skipped. Other errors are reported as
+  /// `std::system_error` exceptions.
+  class dir_walker
+  {
+  public:
+    /// @brief Type of lengths and depths.
+    using size_type = std::size_t;
+
+    /// @brief Type of a directory entry.
+    enum class entry_type
+    {
+      unknown,
+      regular,
+      directory,
+      symlink,
+      other
+    };
+
+    /// @brief Entry of the walked tree, valid until the walker advances.
+    struct entry
+    {
+      /// @brief Null-terminated path, beginning with the root path.
+      const char *path{};
+
+      /// @brief Length of the path.
+      size_type length{};
+
+      /// @brief Offset of the entry name in the path.
+      size_type name_offset{};
+
+      /// @brief Nesting level below the root directory, beginning with 0.
+      size_type depth{};
+
+      /// @brief Type of the entry.
+      entry_type type{};
+
+      /// @brief Provides the null-terminated path, which makes the entry a
+      ///        string-like object for `c_str::basic_builder`.
+      constexpr const char *c_str() const noexcept
+      {
+        return path;
+      }
+
+      /// @brief Provides the null-terminated name of the entry.
+      constexpr const char *name() const noexcept
+      {
+        return path + name_offset;
+      }
+
+      /// @brief Provides the path as a string view.
+      constexpr std::string_view view() const noexcept
+      {
+        return { path, length };
+      }
+    };
+
+    /// @brief Input iterator over the entries of a `c_str::dir_walker`.
+    class iterator
+    {
+      dir_walker *_m_walker{};
+
+    public:
+      /// @brief Iterator category.
+      using iterator_concept = std::input_iterator_tag;
+
+      /// @brief Type of the referenced entries.
+      using value_type = entry;
+
+      /// @brief Difference type.
+      using difference_type = std::ptrdiff_t;
+
+      /// @brief Default constructor.
+      iterator() noexcept = default;
+
+      /// @brief Create an iterator for `walker`.
+      explicit iterator(dir_walker &walker) noexcept :
+        _m_walker{ std::addressof(walker) }
+      {
+      }
+
+      /// @brief Provides the current entry.
+      const entry &operator*() const noexcept
+      {
+        return _m_walker->current();
+      }
+
+      /// @brief Provides the current entry.
+      const entry *operator->() const noexcept
+      {
+        return std::addressof(_m_walker->current());
+      }
+
+      /// @brief Advance to the next entry.
+      iterator &operator++()
+      {
+        _m_walker->next();
+        return *this;
+      }
+
+      /// @brief Advance to the next entry.
+      void operator++(int)
+      {
+        _m_walker->next();
+      }
+
+      /// @brief Check whether the walk is complete.
+      friend bool operator==(const iterator &it, std::default_sentinel_t) noexcept
+      {
+        return !it._m_walker || it._m_walker->done();
+      }
+    };
+
+  private:
+    struct _level
+    {
+      size_type prefix{}; // length of the parent path including the trailing slash
+#if defined(__linux__)
+      int fd{ -1 };
+      std::unique_ptr<char[]> buf{};
+      size_type pos{};
+      size_type end{};
+#else
+      DIR *dir{};
+#endif
+    };
+
+#if defined(__linux__)
+    struct _linux_dirent64
+    {
+      std::uint64_t d_ino;
+      std::int64_t d_off;
+      unsigned short d_reclen;
+      unsigned char d_type;
+      char d_name[1];
+    };
+
+    static constexpr size_type _m_read_size{ 32768 };
+#endif
+
+    std::string _m_path{}; // the reused path buffer
+    std::vector<_level> _m_levels{}; // levels are kept for reuse, including their read buffers
+    size_type _m_depth{}; // number of open levels
+    entry _m_entry{};
+    bool _m_descend{}; // the current entry is a directory to be walked next
+    bool _m_done{};
+
+    static entry_type _type_of(const unsigned char dirType) noexcept
+    {
+      switch (dirType)
+      {
+#if defined(DT_REG)
+        case DT_REG:
+          return entry_type::regular;
+        case DT_DIR:
+          return entry_type::directory;
+        case DT_LNK:
+          return entry_type::symlink;
+        case DT_UNKNOWN:
+          return entry_type::unknown;
+#endif
+        default:
+          return entry_type::other;
+      }
+    }
+
+    static entry_type _type_of_stat(const int dirFd, const char *const name) noexcept
+    {
+      struct stat info{};
+      if (::fstatat(dirFd, name, &info, AT_SYMLINK_NOFOLLOW))
+        return entry_type::unknown;
+
+      return S_ISREG(info.st_mode) ? entry_type::regular :
+             S_ISDIR(info.st_mode) ? entry_type::directory :
+             S_ISLNK(info.st_mode) ? entry_type::symlink :
+                                     entry_type::other;
+    }
+
+    // a symlinked root is followed, the walk itself never follows symlinks
+    static int _open_flags(const bool follow) noexcept
+    {
+      return follow ? O_RDONLY | O_DIRECTORY | O_CLOEXEC : O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC;
+    }
+
+    [[noreturn]] static void _throw_errno(const char *const what)
+    {
+      throw std::system_error{ errno, std::generic_category(), what };
+    }
+
+    int _fd_of(const _level &lvl) const noexcept
+    {
+#if defined(__linux__)
+      return lvl.fd;
+#else
+      return ::dirfd(lvl.dir);
+#endif
+    }
+
+    void _close(_level &lvl) noexcept
+    {
+#if defined(__linux__)
+      if (lvl.fd >= 0)
+        ::close(lvl.fd);
+
+      lvl.fd = -1;
+#else
+      if (lvl.dir)
+        ::closedir(lvl.dir);
+
+      lvl.dir = nullptr;
+#endif
+    }
+
+    bool _push(const int fd)
+    {
+      if (fd < 0)
+      {
+        if (errno == EACCES || errno == EPERM || errno == ENOENT || errno == ENOTDIR || errno == ELOOP)
+          return false; // skipped, like a subdirectory that vanished or can't be entered
+
+        _throw_errno("c_str::dir_walker: opening a directory failed");
+      }
+
+      try
+      {
+        if (_m_depth == _m_levels.size())
+          _m_levels.emplace_back();
+
+#if defined(__linux__)
+        if (!_m_levels[_m_depth].buf)
+          _m_levels[_m_depth].buf = std::make_unique_for_overwrite<char[]>(_m_read_size);
+#endif
+      }
+      catch (...)
+      {
+        ::close(fd);
+        throw;
+      }
+
+      auto &lvl{ _m_levels[_m_depth] };
+#if defined(__linux__)
+      lvl.fd = fd;
+
+      lvl.pos = lvl.end = 0;
+#else
+      lvl.dir = ::fdopendir(fd);
+      if (!lvl.dir)
+      {
+        ::close(fd);
+        _throw_errno("c_str::dir_walker: opening a directory failed");
+      }
+#endif
+      if (_m_path.empty() || _m_path.back() != '/')
+        _m_path.push_back('/');
+
+      lvl.prefix = _m_path.size();
+      ++_m_depth;
+      return true;
+    }
+
+    // provides the next name in the directory of the given level, or a null pointer at the end
+    const char *_read(_level &lvl, unsigned char &dirType)
+    {
+#if defined(__linux__)
+      if (lvl.pos >= lvl.end)
+      {
+        const auto count{ ::syscall(SYS_getdents64, lvl.fd, lvl.buf.get(), _m_read_size) };
+        if (count < 0)
+          _throw_errno("c_str::dir_walker: reading a directory failed");
+
+        if (!count)
+          return nullptr;
+
+        lvl.pos = 0;
+        lvl.end = static_cast<size_type>(count);
+      }
+
+      const auto dirEnt{ reinterpret_cast<const _linux_dirent64 *>(lvl.buf.get() + lvl.pos) };
+      lvl.pos += dirEnt->d_reclen;
+      dirType = dirEnt->d_type;
+      return dirEnt->d_name;
+#else
+      errno = 0;
+      const auto dirEnt{ ::readdir(lvl.dir) };
+      if (!dirEnt)
+      {
+        if (errno)
+          _throw_errno("c_str::dir_walker: reading a directory failed");
+
+        return nullptr;
+      }
+
+#  if defined(DT_UNKNOWN)
+      dirType = dirEnt->d_type;
+#  else
+      dirType = 0;
+#  endif
+      return dirEnt->d_name;
+#endif
+    }
+
+  public:
+    /// @brief Create a walker for the directory tree below `root`.
+    /// @tparam StrLikeT  Type of the string-like object specifying the root
+    ///                   directory.
+    /// @param root  Path of the root directory.
+    template<class StrLikeT>
+    explicit dir_walker(const StrLikeT &root)
+      requires string_like<StrLikeT>
+    {
+      const builder rootPath{ root };
+      _m_path.reserve(4096);
+      _m_path.assign(rootPath.get());
+      if (!_push(::open(rootPath.get(), _open_flags(true))))
+        _throw_errno("c_str::dir_walker: opening the root directory failed");
+
+      try
+      {
+        next();
+      }
+      catch (...)
+      {
+        for (auto &lvl : _m_levels) // the destructor is not called
+          _close(lvl);
+
+        throw;
+      }
+    }
+
+    dir_walker(const dir_walker &) = delete;
+    dir_walker &operator=(const dir_walker &) = delete;
+
+    /// @brief Destructor closing the open directories.
+    ~dir_walker()
+    {
+      for (auto &lvl : _m_levels)
+        _close(lvl);
+    }
+
+    /// @brief Advance to the next entry.
+    /// @return `false` if the walk is complete.
+    bool next()
+    {
+      if (_m_descend)
+      {
+        _m_descend = false;
+        _push(::openat(_fd_of(_m_levels[_m_depth - 1]), _m_entry.name(), _open_flags(false)));
+      }
+
+      while (_m_depth)
+      {
+        auto &lvl{ _m_levels[_m_depth - 1] };
+        unsigned char dirType{};
+        const auto name{ _read(lvl, dirType) };
+        if (!name)
+        {
+          _close(lvl);
+          --_m_depth;
+          continue;
+        }
+
+        if (name[0] == '.' && (!name[1] || (name[1] == '.' && !name[2])))
+          continue;
+
+        _m_path.resize(lvl.prefix);
+        _m_path.append(name);
+        auto type{ _type_of(dirType) };
+        if (type == entry_type::unknown)
+          type = _type_of_stat(_fd_of(lvl), name);
+
+        _m_entry = { _m_path.c_str(), _m_path.size(), lvl.prefix, _m_depth - 1, type };
+        _m_descend = type == entry_type::directory;
+        return true;
+      }
+
+      _m_entry = {};
+      _m_done = true;
+      return false;
+    }
+
+    /// @brief Provides the current entry.
+    const entry &current() const noexcept
+    {
+      return _m_entry;
+    }
+
+    /// @brief Check whether the walk is complete.
+    bool done() const noexcept
+    {
+      return _m_done;
+    }
+
+    /// @brief Skip the content of the current entry if it is a directory.
+    void disable_recursion_pending() noexcept
+    {
+      _m_descend = false;
+    }
+
+    /// @brief Provides an iterator referring to the current entry.
+    iterator begin() noexcept
+    {
+      return iterator{ *this };
+    }
+
+    /// @brief Provides the sentinel for the end of the walk.
+    std::default_sentinel_t end() const noexcept
+    {
+      return std::default_sentinel;
+    }
+  };
+
+} // namespace c_str
+
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#endif
+
+#endif // include guard
@@ -0,0 +1,185 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str_env_snapshot.hpp
+/// @brief     Hash index of the environment variables, providing their values
+///            as C-strings without copying.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C++20.
+
+#ifndef C_STR_ENV_SNAPSHOT_E81C3F05_7A2D_4B96_8D4E_0C59B6A2F713_1_0
+/// @cond _NO_DOC_
+#define C_STR_ENV_SNAPSHOT_E81C3F05_7A2D_4B96_8D4E_0C59B6A2F713_1_0
+/// @endcond
+
+#include <cstddef>
+#include <string_view>
+#include <unordered_map>
+#include "c_str_builder.hpp"
+
+#if defined(_WIN32)
+#  include <stdlib.h> // _environ
+#elif defined(__APPLE__)
+#  include <crt_externs.h> // _NSGetEnviron()
+#else
+#  include <unistd.h> // environ
+#endif
+
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wc++98-compat" // C++20 is required anyway
+#elif defined(_MSC_VER)
+#  pragma warning(push)
+#  pragma warning(disable : 4710 4711) // functions may or may not be inlined
+#endif
+
+namespace c_str
+{
+
+  /// @brief The `c_str::env_snapshot` class indexes the environment of the
+  ///        process once, for lookups of environment variables in constant
+  ///        time.
+  ///
+  /// Unlike `getenv()`, the lookup functions accept names of any string-like
+  /// type convertible to `std::string_view` (and `c_str::basic_builder`
+  /// objects), without the need of a terminating null. Lookups don't
+  /// allocate. The values are the terminated strings of the original
+  /// `"name=value"` entries of the environment, they are never copied. <br>
+  /// The snapshot doesn't see modifications of the environment, and values
+  /// of modified variables may become invalid. Call `refresh()` after
+  /// `setenv()`, `unsetenv()`, or `putenv()`. As for `getenv()`, modifying the
+  /// environment concurrently with `refresh()` or the constructor is a data
+  /// race. If a name occurs more than once, the first entry is used, like
+  /// `getenv()` does.
+  /// @code
+  ///   const c_str::env_snapshot env{};
+  ///   const std::string_view key{ "HOME" };
+  ///   if (const auto home{ env.find(key) })
+  ///     std::puts(home);
+  /// @endcode
+  class env_snapshot
+  {
+  public:
+    /// @brief Type of lengths and sizes.
+    using size_type = std::size_t;
+
+  private:
+    std::unordered_map<std::string_view, std::string_view, transparent_hash<>, transparent_equal_to<>> _m_index{}; // name => value, both pointing into the environment
+
+    static char **_environment() noexcept
+    {
+#if defined(_WIN32)
+      return _environ;
+#elif defined(__APPLE__)
+      return *_NSGetEnviron();
+#else
+      return environ;
+#endif
+    }
+
+  public:
+    /// @brief Default constructor, indexes the current environment.
+    /// @throw std::bad_alloc if the index cannot be allocated.
+    env_snapshot()
+    {
+      refresh();
+    }
+
+    /// @brief Indexes the current environment again, e.g. after environment
+    ///        variables have been set or removed.
+    /// @throw std::bad_alloc if the index cannot be allocated. The snapshot is
+    ///        empty then.
+    void refresh()
+    {
+      _m_index.clear();
+      const auto env{ _environment() };
+      if (!env)
+        return;
+
+      size_type count{};
+      while (env[count])
+        ++count;
+
+      try
+      {
+        _m_index.reserve(count);
+        for (auto entry{ env }; *entry; ++entry)
+        {
+          const std::string_view var{ *entry };
+          const auto sep{ var.find('=', 1) }; // on Windows, names of hidden variables (like "=C:") begin with '='
+          if (sep != std::string_view::npos)
+            _m_index.try_emplace(var.substr(0, sep), var.substr(sep + 1));
+        }
+      }
+      catch (...)
+      {
+        _m_index.clear();
+        throw;
+      }
+    }
+
+    /// @brief Provides the value of an environment variable.
+    /// @param name  Name of the variable, a `c_str::basic_builder` or an object
+    ///              convertible to `std::string_view`.
+    /// @return Pointer to the null-terminated value, or a null pointer if the
+    ///         variable doesn't exist.
+    template<class StrT>
+    const char *find(const StrT &name) const noexcept
+    {
+      const auto found{ _m_index.find(transparent_hash<>::_view_of(name)) };
+      return found != _m_index.end() ? found->second.data() : nullptr;
+    }
+
+    /// @brief Provides the value of an environment variable as a
+    ///        `c_str::basic_builder` referring to the environment.
+    /// @tparam NullBehavior  Value of the `c_str::if_null` enumeration, which
+    ///                       determines the result for a variable that
+    ///                       doesn't exist. See @ref NullBehavior.
+    /// @param name  Name of the variable, a `c_str::basic_builder` or an object
+    ///              convertible to `std::string_view`.
+    /// @return `c_str::basic_builder` object referring to the value.
+    template<if_null NullBehavior = if_null::DEF_NULL_BEHAVIOR, class StrT>
+    basic_builder<char, NullBehavior> get(const StrT &name) const noexcept
+    {
+      return basic_builder<char, NullBehavior>{ find(name) };
+    }
+
+    /// @brief Provides the value of an environment variable as
+    ///        `std::string_view`, whose character behind the end is the
+    ///        terminating null.
+    /// @param name  Name of the variable, a `c_str::basic_builder` or an object
+    ///              convertible to `std::string_view`.
+    /// @return View of the value, or an empty view with a null pointer if the
+    ///         variable doesn't exist.
+    template<class StrT>
+    std::string_view view(const StrT &name) const noexcept
+    {
+      const auto found{ _m_index.find(transparent_hash<>::_view_of(name)) };
+      return found != _m_index.end() ? found->second : std::string_view{};
+    }
+
+    /// @brief Checks whether an environment variable exists.
+    template<class StrT>
+    bool contains(const StrT &name) const noexcept
+    {
+      return _m_index.contains(transparent_hash<>::_view_of(name));
+    }
+
+    /// @brief Provides the number of indexed environment variables.
+    size_type size() const noexcept
+    {
+      return _m_index.size();
+    }
+  };
+
+} // namespace c_str
+
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#elif defined(_MSC_VER)
+#  pragma warning(pop)
+#endif
+
+#endif // include guard
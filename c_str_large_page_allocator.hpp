@@ -0,0 +1,189 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str_large_page_allocator.hpp
+/// @brief     Allocator mapping large owned buffers of a `c_str::basic_builder`
+///            directly from the operating system.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C++20.
+
+#ifndef C_STR_LARGE_PAGE_ALLOCATOR_75F9C70D_CD04_4AAC_A58B_7DCD61DC74EB_1_0
+/// @cond _NO_DOC_
+#define C_STR_LARGE_PAGE_ALLOCATOR_75F9C70D_CD04_4AAC_A58B_7DCD61DC74EB_1_0
+/// @endcond
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include "c_str_builder.hpp"
+
+#if __has_include(<sys/mman.h>)
+#  include <sys/mman.h>
+/// @cond _NO_DOC_
+#  define C_STR_HAS_MMAP_
+/// @endcond
+#endif
+
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wc++98-compat" // C++20 is required anyway
+#elif defined(_MSC_VER)
+#  pragma warning(push)
+#  pragma warning(disable : 4710 4711) // functions may or may not be inlined
+#endif
+
+namespace c_str
+{
+
+  /// @brief The `c_str::large_page_allocator` class template is an allocator
+  ///        that maps buffers of at least `ThresholdBytes` bytes directly from
+  ///        the operating system.
+  ///
+  /// Large buffers are mapped using `mmap()`. Buffers of at least 2 MiB are
+  /// aligned to a 2 MiB boundary and advised to be backed by transparent huge
+  /// pages on Linux, which reduces TLB misses when the buffer is processed.
+  /// Returning a mapped buffer immediately releases the memory to the
+  /// operating system instead of leaving a fragmented heap behind. <br>
+  /// Smaller buffers are allocated using `std::allocator`, so the allocator
+  /// does not slow down the copying of short strings. On platforms without
+  /// `mmap()` every buffer is allocated using `std::allocator`.
+  ///
+  /// @tparam T               Value type of the allocated elements.
+  /// @tparam ThresholdBytes  Size in bytes from which on buffers get mapped.
+  template<class T, std::size_t ThresholdBytes = (C_STR_LARGE_COPY_THRESHOLD > 0 ? C_STR_LARGE_COPY_THRESHOLD : 1048576)>
+  class large_page_allocator
+  {
+  public:
+    /// @brief Type of the allocated elements.
+    using value_type = T;
+
+    /// @brief Type of the number of allocated elements.
+    using size_type = std::size_t;
+
+    /// @brief All instances of the allocator are interchangeable.
+    using is_always_equal = std::true_type;
+
+    /// @brief Buffers follow the string on move assignment.
+    using propagate_on_container_move_assignment = std::true_type;
+
+    /// @brief Rebinds the allocator to another value type.
+    template<class U>
+    struct rebind
+    {
+      /// @brief Allocator type for elements of type `U`.
+      using other = large_page_allocator<U, ThresholdBytes>;
+    };
+
+    /// @brief Size in bytes from which on buffers get mapped.
+    static constexpr std::size_t threshold{ ThresholdBytes };
+
+  private:
+    static constexpr std::size_t _m_page_size{ 4096 };
+    static constexpr std::size_t _m_huge_page_size{ 2097152 };
+
+    static constexpr std::size_t _mapped_bytes(const size_type count) noexcept
+    {
+      return (count * sizeof(value_type) + _m_page_size - 1) & ~(_m_page_size - 1);
+    }
+
+#if defined(C_STR_HAS_MMAP_)
+    static value_type *_map(const std::size_t bytes)
+    {
+      if (bytes < _m_huge_page_size)
+      {
+        const auto buf{ ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) };
+        if (buf == MAP_FAILED)
+          throw std::bad_alloc{};
+
+        return static_cast<value_type *>(buf);
+      }
+
+      // over-map to be able to align the buffer to a huge page boundary, then trim the surplus
+      const auto raw{ ::mmap(nullptr, bytes + _m_huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) };
+      if (raw == MAP_FAILED)
+        throw std::bad_alloc{};
+
+      const auto rawAddr{ reinterpret_cast<std::uintptr_t>(raw) };
+      const auto alignedAddr{ (rawAddr + _m_huge_page_size - 1) & ~std::uintptr_t{ _m_huge_page_size - 1 } };
+      if (const auto head{ alignedAddr - rawAddr }; head)
+        static_cast<void>(::munmap(raw, head));
+
+      if (const auto tail{ _m_huge_page_size - (alignedAddr - rawAddr) }; tail)
+        static_cast<void>(::munmap(reinterpret_cast<void *>(alignedAddr + bytes), tail));
+
+      const auto buf{ reinterpret_cast<void *>(alignedAddr) };
+#  if defined(MADV_HUGEPAGE)
+      static_cast<void>(::madvise(buf, bytes, MADV_HUGEPAGE)); // only a hint, failing is not an error
+#  endif
+      return static_cast<value_type *>(buf);
+    }
+#endif
+
+  public:
+    /// @brief Default constructor.
+    constexpr large_page_allocator() noexcept = default;
+
+    /// @brief Converting constructor for a rebound allocator.
+    template<class U>
+    constexpr large_page_allocator(const large_page_allocator<U, ThresholdBytes> &) noexcept
+    {
+    }
+
+    /// @brief Allocate a buffer for `count` elements.
+    /// @param count  Number of elements.
+    /// @return Pointer to the first element of the uninitialized buffer.
+    [[nodiscard]] constexpr value_type *allocate(const size_type count)
+    {
+#if defined(C_STR_HAS_MMAP_)
+      if (!std::is_constant_evaluated() && count >= (threshold + sizeof(value_type) - 1) / sizeof(value_type))
+      {
+        if (count > (std::numeric_limits<size_type>::max)() / sizeof(value_type) - _m_huge_page_size)
+          throw std::bad_array_new_length{};
+
+        return _map(_mapped_bytes(count));
+      }
+#endif
+      return std::allocator<value_type>{}.allocate(count);
+    }
+
+    /// @brief Release a buffer obtained from `allocate()`.
+    /// @param buf    Pointer returned by `allocate()`.
+    /// @param count  Number of elements passed to `allocate()`.
+    constexpr void deallocate(value_type *const buf, const size_type count) noexcept
+    {
+#if defined(C_STR_HAS_MMAP_)
+      if (!std::is_constant_evaluated() && count >= (threshold + sizeof(value_type) - 1) / sizeof(value_type))
+      {
+        static_cast<void>(::munmap(buf, _mapped_bytes(count)));
+        return;
+      }
+#endif
+      std::allocator<value_type>{}.deallocate(buf, count);
+    }
+
+    /// @brief All instances of the allocator compare equal.
+    friend constexpr bool operator==(const large_page_allocator &, const large_page_allocator &) noexcept
+    {
+      return true;
+    }
+  };
+
+  /// @brief `c_str::basic_large_builder` is a `c_str::basic_builder` that maps
+  ///        large owned buffers directly from the operating system.
+  template<common_char_type CharT, if_null NullBehavior = if_null::DEF_NULL_BEHAVIOR>
+  using basic_large_builder = basic_builder<CharT, NullBehavior, large_page_allocator<CharT>>;
+
+} // namespace c_str
+
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#elif defined(_MSC_VER)
+#  pragma warning(pop)
+#endif
+
+#endif // include guard
@@ -0,0 +1,332 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str_memo_builder.hpp
+/// @brief     Builder variant reusing terminated copies of repeatedly converted
+///            source buffers from a per-thread cache.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C++20.
+
+#ifndef C_STR_MEMO_BUILDER_6FD3ABEC_C41D_4BC8_B63D_E33145CAC7C8_1_0
+/// @cond _NO_DOC_
+#define C_STR_MEMO_BUILDER_6FD3ABEC_C41D_4BC8_B63D_E33145CAC7C8_1_0
+/// @endcond
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "c_str_builder.hpp"
+
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wc++98-compat" // C++20 is required anyway
+#elif defined(_MSC_VER)
+#  pragma warning(push)
+#  pragma warning(disable : 4710 4711) // functions may or may not be inlined
+#endif
+
+namespace c_str
+{
+
+  /// @brief The `c_str::basic_memo_cache` class template is a fixed-size,
+  ///        set-associative cache of null-terminated copies of character
+  ///        buffers, keyed by the address and size of the source buffer.
+  ///
+  /// Each thread has its own cache, accessed via `instance()`. A cached copy
+  /// is only reused if the content of the source buffer still equals the
+  /// copy, so a modified or reused source buffer never yields outdated
+  /// content. Comparing the content is still considerably cheaper than
+  /// allocating and copying. <br>
+  /// The memory held by the cache is bounded by `max_bytes`. Sequences longer
+  /// than `max_length` characters are never cached. If a set is full, the
+  /// least recently used entry of the set is replaced. Cached copies are
+  /// shared with the `c_str::basic_memo_builder` objects using them, thus
+  /// replacing or invalidating an entry never invalidates a provided pointer.
+  ///
+  /// @tparam CharT      Value type of the characters.
+  /// @tparam Sets       Number of sets, a power of 2.
+  /// @tparam Ways       Number of entries per set.
+  /// @tparam MaxLength  Maximum number of characters of a cached sequence.
+  template<common_char_type CharT, std::size_t Sets = 64, std::size_t Ways = 4, std::size_t MaxLength = 256>
+  class basic_memo_cache
+  {
+    static_assert(Sets && !(Sets & (Sets - 1)), "Sets must be a power of 2.");
+    static_assert(Ways, "Ways must not be 0.");
+
+  public:
+    /// @brief Character type of the `CharT` template parameter.
+    using value_type = CharT;
+
+    /// @brief Type of lengths and sizes.
+    using size_type = std::size_t;
+
+    /// @brief Type of a cached copy.
+    using string_type = std::basic_string<value_type>;
+
+    /// @brief Type of the shared reference to a cached copy.
+    using handle_type = std::shared_ptr<const string_type>;
+
+    /// @brief Maximum number of characters of a cached sequence.
+    static constexpr size_type max_length{ MaxLength };
+
+    /// @brief Upper bound of the bytes held by the character buffers of the
+    ///        cached copies of a thread.
+    static constexpr size_type max_bytes{ Sets * Ways * (MaxLength + 1) * sizeof(value_type) };
+
+  private:
+    using _traits_type = typename string_type::traits_type;
+
+    struct _entry
+    {
+      const value_type *src{};
+      size_type size{};
+      std::uint64_t stamp{}; // time of the last use, 0 for an unused entry
+      handle_type copy{};
+    };
+
+    _entry _m_entries[Sets * Ways]{};
+    std::uint64_t _m_clock{};
+
+    static constexpr size_type _set_of(const value_type *const src, const size_type size) noexcept
+    {
+      auto key{ static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(src)) ^ (static_cast<std::uint64_t>(size) * 0x9E3779B97F4A7C15U) };
+      key *= 0xFF51AFD7ED558CCDU;
+      key ^= key >> 33;
+      return static_cast<size_type>(key) & (Sets - 1);
+    }
+
+    constexpr basic_memo_cache() noexcept = default;
+
+  public:
+    basic_memo_cache(const basic_memo_cache &) = delete;
+    basic_memo_cache &operator=(const basic_memo_cache &) = delete;
+
+    /// @brief Provide the cache of the calling thread.
+    /// @return Reference to the cache of the calling thread.
+    static basic_memo_cache &instance() noexcept
+    {
+      thread_local basic_memo_cache cache{};
+      return cache;
+    }
+
+    /// @brief Provide a null-terminated copy of a character sequence, reusing
+    ///        a cached copy if possible.
+    /// @pre `size` is not greater than `max_length`.
+    /// @param src   Pointer to the first character of the sequence.
+    /// @param size  Number of characters in the sequence.
+    /// @return Shared reference to the copy.
+    handle_type acquire(const value_type *const src, const size_type size)
+    {
+      const auto set{ _m_entries + _set_of(src, size) * Ways };
+      auto victim{ set };
+      for (auto entry{ set }; entry != set + Ways; ++entry)
+      {
+        if (entry->stamp && entry->src == src && entry->size == size)
+        {
+          if (!_traits_type::compare(entry->copy->data(), src, size)) // hit
+          {
+            entry->stamp = ++_m_clock;
+            return entry->copy;
+          }
+
+          victim = entry; // the source buffer has been changed since => replace the outdated copy
+          break;
+        }
+
+        if (entry->stamp < victim->stamp)
+          victim = entry;
+      }
+
+      victim->copy = std::make_shared<const string_type>(src, size);
+      victim->src = src;
+      victim->size = size;
+      victim->stamp = ++_m_clock;
+      return victim->copy;
+    }
+
+    /// @brief Remove the cached copy of a character sequence.
+    /// @param src   Pointer to the first character of the sequence.
+    /// @param size  Number of characters in the sequence.
+    void invalidate(const value_type *const src, const size_type size) noexcept
+    {
+      const auto set{ _m_entries + _set_of(src, size) * Ways };
+      for (auto entry{ set }; entry != set + Ways; ++entry)
+        if (entry->stamp && entry->src == src && entry->size == size)
+          *entry = {};
+    }
+
+    /// @brief Remove the cached copies of all character sequences beginning
+    ///        in the memory range [`first`, `last`), e.g. before the memory
+    ///        is released.
+    /// @param first  Beginning of the memory range.
+    /// @param last   End of the memory range.
+    void invalidate_range(const void *const first, const void *const last) noexcept
+    {
+      const auto firstAddr{ reinterpret_cast<std::uintptr_t>(first) };
+      const auto lastAddr{ reinterpret_cast<std::uintptr_t>(last) };
+      for (auto &entry : _m_entries)
+        if (const auto addr{ reinterpret_cast<std::uintptr_t>(entry.src) }; entry.stamp && addr >= firstAddr && addr < lastAddr)
+          entry = {};
+    }
+
+    /// @brief Remove all cached copies.
+    void clear() noexcept
+    {
+      for (auto &entry : _m_entries)
+        entry = {};
+    }
+
+    /// @brief Number of cached copies.
+    size_type size() const noexcept
+    {
+      size_type count{};
+      for (const auto &entry : _m_entries)
+        count += entry.stamp != 0;
+
+      return count;
+    }
+
+    /// @brief Number of bytes held by the character buffers of the cached
+    ///        copies, including the terminating nulls.
+    size_type owned_bytes() const noexcept
+    {
+      size_type bytes{};
+      for (const auto &entry : _m_entries)
+        if (entry.stamp)
+          bytes += (entry.size + 1) * sizeof(value_type);
+
+      return bytes;
+    }
+  };
+
+  /// @brief The `c_str::basic_memo_builder` class template provides a C-string
+  ///        like `c_str::basic_builder`, but takes the terminated copy of a
+  ///        contiguous sequence from the per-thread `c_str::basic_memo_cache`.
+  ///
+  /// The class is meant for loops converting the same unterminated buffer
+  /// (same address and size) over and over again, like a configuration key
+  /// that is passed to a C function in every request. Whenever
+  /// `c_str::basic_builder` would not copy, the sequence is not contiguous, or
+  /// it is longer than the `max_length` of the cache, the object behaves
+  /// exactly like a `c_str::basic_builder`. <br>
+  /// Note: A cached copy may outlive the source buffer. Use the
+  /// `invalidate()` or `invalidate_range()` member functions of the cache to
+  /// release the copies of a buffer early.
+  ///
+  /// @tparam CharT         Value type of the characters.
+  /// @tparam NullBehavior  Value of the `c_str::if_null` enumeration. See
+  ///                       @ref NullBehavior.
+  /// @tparam CacheT        Type of the cache.
+  template<common_char_type CharT, if_null NullBehavior = if_null::DEF_NULL_BEHAVIOR, class CacheT = basic_memo_cache<CharT>>
+  class basic_memo_builder
+  {
+  public:
+    /// @brief Character type of the `CharT` template parameter.
+    using value_type = CharT;
+
+    /// @brief Type of the provided pointer to the underlying read-only
+    ///        string-buffer.
+    using const_pointer = const value_type *;
+
+    /// @brief Type of the value returned by the `length()` member function.
+    using size_type = std::size_t;
+
+    /// @brief Type of the cache.
+    using cache_type = CacheT;
+
+    /// @brief Value of the `NullBehavior` template parameter.
+    static constexpr if_null null_behavior{ NullBehavior };
+
+  private:
+    using _builder_type = basic_builder<value_type, null_behavior>;
+
+    _builder_type _m_builder{}; // used if the C-string is not taken from the cache
+    typename cache_type::handle_type _m_memo{}; // cached copy, if any
+
+    template<class StrLikeT>
+    static constexpr bool _is_memoizable(const StrLikeT &strLike) noexcept
+    {
+      if constexpr (contiguous_string_like_of_type<StrLikeT, value_type> && !terminated_string_like_of_type<StrLikeT, value_type> && requires { std::data(strLike); std::size(strLike); })
+        return std::size(strLike) && std::data(strLike)[std::size(strLike) - 1] // the same condition as copying in `c_str::basic_builder`
+               && static_cast<size_type>(std::size(strLike)) <= cache_type::max_length; // longer sequences are never cached, so a plain copy is cheaper
+      else
+        return false;
+    }
+
+  public:
+    /// @brief Default constructor that creates an object like it was
+    ///        constructed from `nullptr`.
+    basic_memo_builder() noexcept = default;
+
+    /// @brief Create a `c_str::basic_memo_builder` object from a string-like
+    ///        object.
+    /// @tparam StrLikeT  Type of the referenced string-like object, or
+    ///                   `nullptr_t`.
+    /// @param strLike  A string-like object, a null pointer of type `CharT *`
+    ///                 or `nullptr`.
+    template<class StrLikeT>
+    basic_memo_builder(const StrLikeT &strLike)
+      requires std::is_null_pointer_v<StrLikeT> || string_like_of_type<StrLikeT, value_type>
+      :
+      _m_builder{ _is_memoizable(strLike) ? _builder_type{} : _builder_type{ strLike } }
+    {
+      if constexpr (requires { std::data(strLike); std::size(strLike); })
+        if (_is_memoizable(strLike))
+          _m_memo = cache_type::instance().acquire(std::data(strLike), static_cast<size_type>(std::size(strLike)));
+    }
+
+    /// @brief Provides a pointer to the C-string, or a null pointer. See
+    ///        `c_str::basic_builder::get()`.
+    const_pointer get() const noexcept
+    {
+      return _m_memo ? _m_memo->c_str() : _m_builder.get();
+    }
+
+    /// @brief Provides the length of the C-string. See
+    ///        `c_str::basic_builder::length()`. For a cached copy, this is
+    ///        the size of the copied sequence, which is not searched for the
+    ///        terminating null. (It includes null characters embedded in the
+    ///        sequence.)
+    size_type length() const noexcept
+    {
+      return _m_memo ? _m_memo->size() : _m_builder.length();
+    }
+
+    /// @brief Provides a `std::basic_string_view` of the C-string. See
+    ///        `c_str::basic_builder::view()` and `length()`.
+    std::basic_string_view<value_type> view() const noexcept
+    {
+      return _m_memo ? std::basic_string_view<value_type>{ *_m_memo } : _m_builder.view();
+    }
+
+    /// @brief Exchanges the contents of this object with those of `other`.
+    void swap(basic_memo_builder &other) noexcept
+    {
+      _m_builder.swap(other._m_builder);
+      _m_memo.swap(other._m_memo);
+    }
+  };
+
+  /// @brief `c_str::memo_builder` is a type definition for
+  ///        `c_str::basic_memo_builder<char>`.
+  typedef basic_memo_builder<char> memo_builder;
+
+  /// @brief `c_str::wmemo_builder` is a type definition for
+  ///        `c_str::basic_memo_builder<wchar_t>`.
+  typedef basic_memo_builder<wchar_t> wmemo_builder;
+
+} // namespace c_str
+
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#elif defined(_MSC_VER)
+#  pragma warning(pop)
+#endif
+
+#endif // include guard
@@ -0,0 +1,158 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str_padded_allocator.hpp
+/// @brief     Allocator providing padded and aligned owned buffers of a
+///            `c_str::basic_builder` for vectorized consumers.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C++20.
+
+#ifndef C_STR_PADDED_ALLOCATOR_E26F9A0F_3FC0_4BB8_8E4F_6821C5E68C98_1_0
+/// @cond _NO_DOC_
+#define C_STR_PADDED_ALLOCATOR_E26F9A0F_3FC0_4BB8_8E4F_6821C5E68C98_1_0
+/// @endcond
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include "c_str_builder.hpp"
+
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wc++98-compat" // C++20 is required anyway
+#elif defined(_MSC_VER)
+#  pragma warning(push)
+#  pragma warning(disable : 4710 4711) // functions may or may not be inlined
+#endif
+
+namespace c_str
+{
+
+  /// @brief The `c_str::padded_allocator` class template is an allocator that
+  ///        aligns buffers to `Alignment` bytes and specifies `PaddingBytes`
+  ///        zero bytes to follow the terminating null in the owned buffer of
+  ///        a `c_str::basic_builder`.
+  ///
+  /// SIMD parsers (like simdjson) read their input in blocks and thus need a
+  /// couple of readable bytes behind its end. They also prefer input aligned
+  /// to a cache line. Using this allocator, a copied string can be passed to
+  /// such a parser without copying it into a padded buffer once again. <br>
+  /// Aligned `operator new` takes the slow `memalign` path of common heaps
+  /// (e.g. glibc malloc), which bypasses their per-thread caches. Thus,
+  /// buffers are over-allocated by `Alignment + sizeof(std::size_t) - 1` bytes
+  /// using plain `operator new` and aligned within that block. The offset of
+  /// the aligned buffer is kept in the bytes in front of it.
+  ///
+  /// @tparam T             Value type of the allocated elements.
+  /// @tparam PaddingBytes  Number of zero bytes following the terminating null.
+  /// @tparam Alignment     Alignment of the allocated buffers, a power of 2.
+  template<class T, std::size_t PaddingBytes = 64, std::size_t Alignment = 64>
+  class padded_allocator
+  {
+    static_assert(Alignment >= alignof(T) && !(Alignment & (Alignment - 1)), "Alignment must be a power of 2 and not less than the alignment of T.");
+
+  public:
+    /// @brief Type of the allocated elements.
+    using value_type = T;
+
+    /// @brief Type of the number of allocated elements.
+    using size_type = std::size_t;
+
+    /// @brief All instances of the allocator are interchangeable.
+    using is_always_equal = std::true_type;
+
+    /// @brief Buffers follow the string on move assignment.
+    using propagate_on_container_move_assignment = std::true_type;
+
+    /// @brief Rebinds the allocator to another value type.
+    template<class U>
+    struct rebind
+    {
+      /// @brief Allocator type for elements of type `U`.
+      using other = padded_allocator<U, PaddingBytes, Alignment>;
+    };
+
+    /// @brief Number of zero bytes following the terminating null in the
+    ///        owned buffer of a `c_str::basic_builder`.
+    static constexpr std::size_t padding{ PaddingBytes };
+
+    /// @brief Alignment of the allocated buffers.
+    static constexpr std::size_t alignment{ Alignment };
+
+  private:
+    static constexpr std::size_t _m_overhead{ alignment + sizeof(std::size_t) - 1 }; // room for aligning the buffer and keeping its offset
+
+  public:
+    /// @brief Default constructor.
+    constexpr padded_allocator() noexcept = default;
+
+    /// @brief Converting constructor for a rebound allocator.
+    template<class U>
+    constexpr padded_allocator(const padded_allocator<U, PaddingBytes, Alignment> &) noexcept
+    {
+    }
+
+    /// @brief Allocate a buffer for `count` elements.
+    /// @param count  Number of elements.
+    /// @return Pointer to the first element of the uninitialized buffer.
+    [[nodiscard]] constexpr value_type *allocate(const size_type count)
+    {
+      if (std::is_constant_evaluated())
+        return std::allocator<value_type>{}.allocate(count);
+
+      if (count > ((std::numeric_limits<size_type>::max)() - _m_overhead) / sizeof(value_type))
+        throw std::bad_array_new_length{};
+
+      const auto raw{ static_cast<unsigned char *>(::operator new(count * sizeof(value_type) + _m_overhead)) };
+      const auto offset{ ((alignment - (reinterpret_cast<std::uintptr_t>(raw) + sizeof(std::size_t))) & (alignment - 1)) + sizeof(std::size_t) };
+      std::memcpy(raw + offset - sizeof(std::size_t), &offset, sizeof(std::size_t));
+      return reinterpret_cast<value_type *>(raw + offset);
+    }
+
+    /// @brief Release a buffer obtained from `allocate()`.
+    /// @param buf    Pointer returned by `allocate()`.
+    /// @param count  Number of elements passed to `allocate()`.
+    constexpr void deallocate(value_type *const buf, const size_type count) noexcept
+    {
+      if (std::is_constant_evaluated())
+        std::allocator<value_type>{}.deallocate(buf, count);
+      else
+      {
+        const auto aligned{ reinterpret_cast<unsigned char *>(buf) };
+        std::size_t offset{};
+        std::memcpy(&offset, aligned - sizeof(std::size_t), sizeof(std::size_t));
+        ::operator delete(aligned - offset, count * sizeof(value_type) + _m_overhead);
+      }
+    }
+
+    /// @brief All instances of the allocator compare equal.
+    friend constexpr bool operator==(const padded_allocator &, const padded_allocator &) noexcept
+    {
+      return true;
+    }
+  };
+
+  /// @brief `c_str::basic_padded_builder` is a `c_str::basic_builder` whose
+  ///        owned buffer is padded and aligned for SIMD parsers.
+  template<common_char_type CharT, if_null NullBehavior = if_null::DEF_NULL_BEHAVIOR>
+  using basic_padded_builder = basic_builder<CharT, NullBehavior, padded_allocator<CharT>>;
+
+  /// @brief `c_str::padded_builder` is a type definition for
+  ///        `c_str::basic_padded_builder<char>`.
+  typedef basic_padded_builder<char> padded_builder;
+
+} // namespace c_str
+
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#elif defined(_MSC_VER)
+#  pragma warning(pop)
+#endif
+
+#endif // include guard
@@ -0,0 +1,622 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str_shm_arena.hpp
+/// @brief     Shared-memory arena for owned buffers of `c_str::basic_builder`
+///            objects that are passed to another process.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C++20, and a POSIX system.
+
+#ifndef C_STR_SHM_ARENA_B9ADDBDA_1150_45E0_90FB_A8F739F81768_1_0
+/// @cond _NO_DOC_
+#define C_STR_SHM_ARENA_B9ADDBDA_1150_45E0_90FB_A8F739F81768_1_0
+/// @endcond
+
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include "c_str_builder.hpp"
+
+#if !__has_include(<sys/mman.h>)
+#  error "c_str::shm_arena requires a POSIX system."
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wc++98-compat" // C++20 is required anyway
+#endif
+
+namespace c_str
+{
+
+  /// @brief Handle of a C-string in a `c_str::shm_arena`, which is valid in
+  ///        every process that maps the arena.
+  struct shm_handle
+  {
+    /// @brief Offset of the first character from the beginning of the arena.
+    std::uint64_t offset{};
+
+    /// @brief Number of characters, without the terminating null.
+    std::uint64_t length{};
+  };
+
+  /// @brief The `c_str::shm_arena` class is an arena in shared memory, that
+  ///        can be mapped by several processes.
+  ///
+  /// The memory is obtained from `memfd_create()` (Linux) or `shm_open()`.
+  /// The file descriptor can be passed to another process (e.g. via a Unix
+  /// domain socket, or `/proc/<pid>/fd/<fd>`), or the arena is opened by its
+  /// name. <br>
+  /// Allocations are served from lock-free free lists of power-of-2 size
+  /// classes, and from a bump pointer if the free list is empty. The state of
+  /// the allocator lives in the arena itself and is updated using lock-free
+  /// atomic operations, so all processes mapping the arena may allocate and
+  /// release blocks concurrently. Free lists are tagged to prevent ABA
+  /// problems. Memory is never returned to the operating system before the
+  /// arena is destroyed. <br>
+  /// Pointers into the arena differ among processes. Use `handle_of()` to get
+  /// a `c_str::shm_handle` of a C-string, and `resolve()` to get the C-string
+  /// of a handle in the peer process.
+  class shm_arena
+  {
+  public:
+    /// @brief Type of sizes.
+    using size_type = std::size_t;
+
+  private:
+    static constexpr std::uint64_t _m_magic{ 0x414E455241525453U }; // "STRARENA"
+    static constexpr size_type _m_unit{ 16 }; // granularity of offsets and alignment of blocks
+    static constexpr size_type _m_min_block{ 32 }; // size of a block of size class 0, including its header
+    static constexpr size_type _m_classes{ 32 };
+
+    struct _header
+    {
+      std::uint64_t magic;
+      std::uint64_t size;
+      std::atomic<std::uint64_t> bump; // offset of the unused memory
+      std::atomic<std::uint64_t> free_heads[_m_classes]; // tag in the upper, offset in units in the lower 32 bits
+    };
+
+    struct _block
+    {
+      std::uint32_t size_class;
+      std::uint32_t next; // offset in units of the next free block, used while in a free list
+      std::uint64_t reserved;
+    };
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "lock-free 64-bit atomics are required for the use in shared memory");
+    static_assert(sizeof(_block) == _m_unit);
+
+    static constexpr size_type _m_first_block{ (sizeof(_header) + 63) / 64 * 64 };
+
+    inline static std::atomic<shm_arena *> _m_current{};
+
+    int _m_fd{ -1 };
+    std::byte *_m_base{};
+    size_type _m_size{};
+
+    [[noreturn]] static void _throw_errno(const char *const what)
+    {
+      throw std::system_error{ errno, std::generic_category(), what };
+    }
+
+    _header *_hdr() const noexcept
+    {
+      return reinterpret_cast<_header *>(_m_base);
+    }
+
+    _block *_block_at(const std::uint32_t units) const noexcept
+    {
+      return reinterpret_cast<_block *>(_m_base + static_cast<size_type>(units) * _m_unit);
+    }
+
+    static constexpr size_type _class_of(const size_type bytes) noexcept
+    {
+      const auto total{ bytes + sizeof(_block) };
+      return total <= _m_min_block ? 0 : static_cast<size_type>(std::bit_width(total - 1)) - 5; // 2^5 == _m_min_block
+    }
+
+    void _map(const bool init, const size_type bytes)
+    {
+      if (init && ::ftruncate(_m_fd, static_cast<off_t>(bytes)))
+        _throw_errno("c_str::shm_arena: sizing the shared memory failed");
+
+      struct stat info{};
+      if (::fstat(_m_fd, &info))
+        _throw_errno("c_str::shm_arena: querying the shared memory failed");
+
+      _m_size = static_cast<size_type>(info.st_size);
+      if (_m_size < _m_first_block || _m_size / _m_unit > UINT32_MAX)
+        throw std::system_error{ EINVAL, std::generic_category(), "c_str::shm_arena: invalid size of the shared memory" };
+
+      const auto map{ ::mmap(nullptr, _m_size, PROT_READ | PROT_WRITE, MAP_SHARED, _m_fd, 0) };
+      if (map == MAP_FAILED)
+        _throw_errno("c_str::shm_arena: mapping the shared memory failed");
+
+      _m_base = static_cast<std::byte *>(map);
+      const auto hdr{ _hdr() };
+      if (init) // the new file is zero-filled, thus the free lists are empty
+      {
+        hdr->size = _m_size;
+        hdr->bump.store(_m_first_block, std::memory_order_relaxed);
+        std::atomic_ref<std::uint64_t>{ hdr->magic }.store(_m_magic, std::memory_order_release);
+      }
+      else if (std::atomic_ref<std::uint64_t>{ hdr->magic }.load(std::memory_order_acquire) != _m_magic || hdr->size != _m_size)
+        throw std::system_error{ EINVAL, std::generic_category(), "c_str::shm_arena: the shared memory is not an arena" };
+    }
+
+    void _release() noexcept
+    {
+      if (_m_base)
+        ::munmap(_m_base, _m_size);
+
+      if (_m_fd >= 0)
+        ::close(_m_fd);
+
+      shm_arena *self{ this };
+      _m_current.compare_exchange_strong(self, nullptr);
+      _m_fd = -1;
+      _m_base = nullptr;
+      _m_size = 0;
+    }
+
+    shm_arena(const int fd, const bool init, const size_type bytes) :
+      _m_fd{ fd }
+    {
+      try
+      {
+        _map(init, bytes);
+      }
+      catch (...)
+      {
+        _release();
+        throw;
+      }
+    }
+
+  public:
+    /// @brief Create a new arena.
+    /// @param bytes  Size of the arena in bytes, including its header.
+    /// @param name   Name of the shared memory object for `shm_open()`
+    ///               (like "/name"), or a null pointer for an anonymous
+    ///               `memfd_create()` file on Linux.
+    /// @return The new arena.
+    /// @throw std::system_error if the arena can't be created.
+    static shm_arena create(const size_type bytes, const char *const name = nullptr)
+    {
+      int fd{ -1 };
+      if (name)
+        fd = ::shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+#if defined(__linux__)
+      else
+        fd = ::memfd_create("c_str::shm_arena", MFD_CLOEXEC);
+#else
+      else
+        errno = EINVAL;
+#endif
+      if (fd < 0)
+        _throw_errno("c_str::shm_arena: creating the shared memory failed");
+
+      return shm_arena{ fd, true, bytes };
+    }
+
+    /// @brief Open an existing arena by its name.
+    /// @param name  Name of the shared memory object.
+    /// @return The opened arena.
+    /// @throw std::system_error if the arena can't be opened.
+    static shm_arena open(const char *const name)
+    {
+      const auto fd{ ::shm_open(name, O_RDWR | O_CLOEXEC, 0) };
+      if (fd < 0)
+        _throw_errno("c_str::shm_arena: opening the shared memory failed");
+
+      return shm_arena{ fd, false, 0 };
+    }
+
+    /// @brief Map an existing arena by its file descriptor. The file
+    ///        descriptor is duplicated.
+    /// @param fd  File descriptor of the shared memory object.
+    /// @return The mapped arena.
+    /// @throw std::system_error if the arena can't be mapped.
+    static shm_arena attach(const int fd)
+    {
+      const auto dupFd{ ::fcntl(fd, F_DUPFD_CLOEXEC, 0) };
+      if (dupFd < 0)
+        _throw_errno("c_str::shm_arena: duplicating the file descriptor failed");
+
+      return shm_arena{ dupFd, false, 0 };
+    }
+
+    /// @brief Remove the name of an arena created by name. Mappings remain
+    ///        valid.
+    static void unlink(const char *const name) noexcept
+    {
+      ::shm_unlink(name);
+    }
+
+    /// @brief Move constructor.
+    shm_arena(shm_arena &&other) noexcept :
+      _m_fd{ std::exchange(other._m_fd, -1) },
+      _m_base{ std::exchange(other._m_base, nullptr) },
+      _m_size{ std::exchange(other._m_size, 0) }
+    {
+      shm_arena *src{ std::addressof(other) };
+      _m_current.compare_exchange_strong(src, this); // the current arena follows the move
+    }
+
+    /// @brief Move assignment operator.
+    shm_arena &operator=(shm_arena &&other) noexcept
+    {
+      if (this != std::addressof(other))
+      {
+        _release();
+        _m_fd = std::exchange(other._m_fd, -1);
+        _m_base = std::exchange(other._m_base, nullptr);
+        _m_size = std::exchange(other._m_size, 0);
+        shm_arena *src{ std::addressof(other) };
+        _m_current.compare_exchange_strong(src, this); // the current arena follows the move
+      }
+
+      return *this;
+    }
+
+    /// @brief Destructor unmapping the arena.
+    ~shm_arena()
+    {
+      _release();
+    }
+
+    /// @brief File descriptor of the shared memory object.
+    int fd() const noexcept
+    {
+      return _m_fd;
+    }
+
+    /// @brief Size of the arena in bytes.
+    size_type size() const noexcept
+    {
+      return _m_size;
+    }
+
+    /// @brief Number of bytes not yet used by the bump allocator. Released
+    ///        blocks are not included.
+    size_type unused_bytes() const noexcept
+    {
+      const auto bump{ static_cast<size_type>(_hdr()->bump.load(std::memory_order_relaxed)) };
+      return bump < _m_size ? _m_size - bump : 0;
+    }
+
+    /// @brief Allocate a block of at least `bytes` bytes, aligned to 16
+    ///        bytes.
+    /// @param bytes  Number of bytes.
+    /// @return Pointer to the block.
+    /// @throw std::bad_alloc if the arena is exhausted.
+    void *allocate(const size_type bytes)
+    {
+      const auto sizeClass{ _class_of(bytes) };
+      if (sizeClass >= _m_classes || bytes > _m_size)
+        throw std::bad_alloc{};
+
+      auto &head{ _hdr()->free_heads[sizeClass] };
+      for (auto top{ head.load(std::memory_order_acquire) }; static_cast<std::uint32_t>(top);) // pop from the free list
+      {
+        const auto block{ _block_at(static_cast<std::uint32_t>(top)) };
+        const auto next{ std::atomic_ref<std::uint32_t>{ block->next }.load(std::memory_order_relaxed) }; // may be outdated, then the tag makes the exchange fail
+        if (head.compare_exchange_weak(top, ((top >> 32) + 1) << 32 | next, std::memory_order_acquire, std::memory_order_acquire))
+          return block + 1;
+      }
+
+      const auto blockSize{ _m_min_block << sizeClass };
+      const auto offset{ static_cast<size_type>(_hdr()->bump.fetch_add(blockSize, std::memory_order_relaxed)) };
+      if (offset > _m_size || _m_size - offset < blockSize)
+        throw std::bad_alloc{};
+
+      const auto block{ reinterpret_cast<_block *>(_m_base + offset) };
+      block->size_class = static_cast<std::uint32_t>(sizeClass);
+      return block + 1;
+    }
+
+    /// @brief Release a block obtained from `allocate()`.
+    /// @param ptr  Pointer returned by `allocate()`.
+    void deallocate(void *const ptr, size_type = 0) noexcept
+    {
+      const auto block{ static_cast<_block *>(ptr) - 1 };
+      const auto units{ static_cast<std::uint32_t>(static_cast<size_type>(reinterpret_cast<std::byte *>(block) - _m_base) / _m_unit) };
+      auto &head{ _hdr()->free_heads[block->size_class] };
+      auto top{ head.load(std::memory_order_relaxed) };
+      do
+        std::atomic_ref<std::uint32_t>{ block->next }.store(static_cast<std::uint32_t>(top), std::memory_order_relaxed);
+      while (!head.compare_exchange_weak(top, ((top >> 32) + 1) << 32 | units, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    /// @brief Check whether `ptr` points into the arena.
+    bool contains(const void *const ptr) const noexcept
+    {
+      const auto addr{ reinterpret_cast<std::uintptr_t>(ptr) };
+      const auto base{ reinterpret_cast<std::uintptr_t>(_m_base) };
+      return _m_base && addr >= base && addr - base < _m_size;
+    }
+
+    /// @brief Provides the handle of a C-string in the arena.
+    /// @tparam CharT  Value type of the characters.
+    /// @param cstr  Pointer to a C-string in the arena.
+    /// @return Handle of the C-string, or a zero handle if the C-string is
+    ///         not in the arena.
+    template<common_char_type CharT>
+    shm_handle handle_of(const CharT *const cstr) const noexcept
+    {
+      if (!contains(cstr))
+        return {};
+
+      return { static_cast<std::uint64_t>(reinterpret_cast<const std::byte *>(cstr) - _m_base), std::char_traits<CharT>::length(cstr) };
+    }
+
+    /// @brief Provides the C-string of a handle.
+    /// @tparam CharT  Value type of the characters.
+    /// @param handle  Handle obtained from `handle_of()` in any process
+    ///                mapping the arena.
+    /// @return Pointer to the C-string, or a null pointer for a zero handle or
+    ///         a handle outside of the arena.
+    template<common_char_type CharT>
+    const CharT *resolve(const shm_handle handle) const noexcept
+    {
+      if (!handle.offset || handle.offset >= _m_size || (_m_size - handle.offset) / sizeof(CharT) <= handle.length)
+        return nullptr;
+
+      return reinterpret_cast<const CharT *>(_m_base + handle.offset);
+    }
+
+    /// @brief Provides the arena used by default-constructed
+    ///        `c_str::arena_allocator` objects, or a null pointer.
+    static shm_arena *current() noexcept
+    {
+      return _m_current.load(std::memory_order_acquire);
+    }
+
+    /// @brief Make this arena the one used by default-constructed
+    ///        `c_str::arena_allocator` objects in all threads.
+    void make_current() noexcept
+    {
+      _m_current.store(this, std::memory_order_release);
+    }
+  };
+
+  /// @brief The `c_str::arena_allocator` class template is an allocator
+  ///        obtaining buffers from a `c_str::shm_arena`.
+  ///
+  /// A default-constructed allocator uses the current arena (see
+  /// `c_str::shm_arena::make_current()`). Allocating without a current arena
+  /// fails with a `std::bad_alloc` exception.
+  /// @tparam T  Value type of the allocated elements.
+  template<class T>
+  class arena_allocator
+  {
+    template<class U>
+    friend class arena_allocator;
+
+    shm_arena *_m_arena{ shm_arena::current() };
+
+  public:
+    /// @brief Type of the allocated elements.
+    using value_type = T;
+
+    /// @brief Type of the number of allocated elements.
+    using size_type = std::size_t;
+
+    /// @brief Buffers follow the string on copy assignment.
+    using propagate_on_container_copy_assignment = std::true_type;
+
+    /// @brief Buffers follow the string on move assignment.
+    using propagate_on_container_move_assignment = std::true_type;
+
+    /// @brief Buffers follow the string on swap.
+    using propagate_on_container_swap = std::true_type;
+
+    /// @brief Rebinds the allocator to another value type.
+    template<class U>
+    struct rebind
+    {
+      /// @brief Allocator type for elements of type `U`.
+      using other = arena_allocator<U>;
+    };
+
+    /// @brief Default constructor using the current arena.
+    constexpr arena_allocator() noexcept = default;
+
+    /// @brief Construct an allocator using `arena`.
+    constexpr arena_allocator(shm_arena &arena) noexcept :
+      _m_arena{ std::addressof(arena) }
+    {
+    }
+
+    /// @brief Converting constructor for a rebound allocator.
+    template<class U>
+    constexpr arena_allocator(const arena_allocator<U> &other) noexcept :
+      _m_arena{ other._m_arena }
+    {
+    }
+
+    /// @brief Provides the arena used, or a null pointer.
+    constexpr shm_arena *arena() const noexcept
+    {
+      return _m_arena;
+    }
+
+    /// @brief Allocate a buffer for `count` elements.
+    /// @param count  Number of elements.
+    /// @return Pointer to the first element of the uninitialized buffer.
+    [[nodiscard]] constexpr value_type *allocate(const size_type count)
+    {
+      if (std::is_constant_evaluated())
+        return std::allocator<value_type>{}.allocate(count);
+
+      if (!_m_arena || count > _m_arena->size() / sizeof(value_type))
+        throw std::bad_alloc{};
+
+      return static_cast<value_type *>(_m_arena->allocate(count * sizeof(value_type)));
+    }
+
+    /// @brief Release a buffer obtained from `allocate()`.
+    /// @param buf    Pointer returned by `allocate()`.
+    /// @param count  Number of elements passed to `allocate()`.
+    constexpr void deallocate(value_type *const buf, const size_type count) noexcept
+    {
+      if (std::is_constant_evaluated())
+        std::allocator<value_type>{}.deallocate(buf, count);
+      else
+        _m_arena->deallocate(buf, count * sizeof(value_type));
+    }
+
+    /// @brief Allocators compare equal if they use the same arena.
+    friend constexpr bool operator==(const arena_allocator &lhs, const arena_allocator &rhs) noexcept
+    {
+      return lhs._m_arena == rhs._m_arena;
+    }
+  };
+
+  /// @brief `c_str::basic_arena_builder` is a `c_str::basic_builder` whose
+  ///        owned buffer is allocated in the current `c_str::shm_arena`.
+  template<common_char_type CharT, if_null NullBehavior = if_null::DEF_NULL_BEHAVIOR>
+  using basic_arena_builder = basic_builder<CharT, NullBehavior, arena_allocator<CharT>>;
+
+  /// @brief The `c_str::basic_shm_builder` class template provides a C-string
+  ///        that is guaranteed to be in the current `c_str::shm_arena`, along
+  ///        with its handle for a peer process.
+  ///
+  /// A null-terminated source that is already in the arena is referenced
+  /// without copying. This includes a `std::basic_string_view` of such a
+  /// C-string. Any other source is copied once, directly into the arena.
+  /// Null pointers and zero-length sources result in a zero handle, which
+  /// the peer process resolves to a null pointer. The owned buffer of a copy
+  /// is allocated from the arena of the original.
+  /// @tparam CharT  Value type of the characters.
+  template<common_char_type CharT>
+  class basic_shm_builder
+  {
+  public:
+    /// @brief Type of the `c_str::basic_builder` holding the C-string.
+    using builder_type = basic_arena_builder<CharT, if_null::keep_null_pointer>;
+
+    /// @brief Type of the provided pointer.
+    using const_pointer = typename builder_type::const_pointer;
+
+  private:
+    builder_type _m_builder{};
+    shm_arena *_m_arena{}; // the arena the C-string is in, which is also the arena of the allocator of an owned buffer
+
+    // writes the characters into a buffer allocated from the arena
+    template<class WriterT>
+    static builder_type _copy(const std::size_t length, WriterT writer)
+    {
+      return builder_type::for_overwrite(length, [length, &writer](CharT *const dest) {
+        writer(dest);
+        return length;
+      });
+    }
+
+    static builder_type _copy(const CharT *const ptr, const std::size_t length)
+    {
+      return _copy(length, [ptr, length](CharT *const dest) noexcept {
+        std::char_traits<CharT>::copy(dest, ptr, length);
+      });
+    }
+
+  public:
+    /// @brief Default constructor that creates an object providing a null
+    ///        pointer.
+    basic_shm_builder() noexcept = default;
+
+    /// @brief Create a `c_str::basic_shm_builder` object from a string-like
+    ///        object.
+    /// @tparam StrLikeT  Type of the referenced string-like object, or
+    ///                   `nullptr_t`.
+    /// @param strLike  A string-like object, a null pointer of type `CharT *`
+    ///                 or `nullptr`.
+    /// @throw std::bad_alloc if there is no current arena or it is
+    ///        exhausted.
+    template<class StrLikeT>
+    basic_shm_builder(const StrLikeT &strLike)
+      requires std::is_null_pointer_v<StrLikeT> || string_like_of_type<StrLikeT, CharT>
+    {
+      const auto arena{ shm_arena::current() };
+      if (!arena)
+        throw std::bad_alloc{};
+
+      _m_arena = arena;
+      if constexpr (std::is_null_pointer_v<StrLikeT> || std::is_pointer_v<StrLikeT> ||
+                    terminated_string_like_of_type<StrLikeT, CharT> || null_terminated_range_of_type<StrLikeT, CharT>)
+      {
+        const auto ptr{ builder_type{ strLike }.get() }; // never copies
+        if (ptr && *ptr)
+          _m_builder = arena->contains(ptr) ? builder_type{ ptr } : _copy(ptr, std::char_traits<CharT>::length(ptr));
+      }
+      else if constexpr (contiguous_string_like_of_type<StrLikeT, CharT> && requires { std::data(strLike); std::size(strLike); })
+      {
+        const CharT *const data{ std::data(strLike) };
+        const auto size{ static_cast<std::size_t>(std::size(strLike)) };
+        if (size && data[size - 1] && arena->contains(data) && arena->contains(data + size) && !data[size]) // terminated behind the sequence, e.g. a view of a C-string in the arena
+          _m_builder = builder_type{ data };
+        else if (size && !data[size - 1]) // terminated at the end of the sequence
+        {
+          if (*data)
+            _m_builder = arena->contains(data) ? builder_type{ data } : _copy(data, std::char_traits<CharT>::length(data));
+        }
+        else if (size)
+          _m_builder = _copy(data, size);
+      }
+      else
+      {
+        std::size_t length{};
+        for (auto it{ std::begin(strLike) }; it != std::end(strLike); ++it)
+          ++length;
+
+        if (length)
+          _m_builder = _copy(length, [&strLike](CharT *dest) {
+            for (auto it{ std::begin(strLike) }; it != std::end(strLike); ++it, ++dest)
+              *dest = *it;
+          });
+      }
+    }
+
+    /// @brief Provides the pointer to the C-string, or a null pointer.
+    const_pointer get() const noexcept
+    {
+      return _m_builder.get();
+    }
+
+    /// @brief Provides the handle of the C-string for a peer process. The
+    ///        handle refers to the arena that was current when the object was
+    ///        created, even if another arena has been made current since.
+    shm_handle handle() const noexcept
+    {
+      return _m_arena && _m_builder.get() ? _m_arena->handle_of(_m_builder.get()) : shm_handle{};
+    }
+  };
+
+  /// @brief `c_str::shm_builder` is a type definition for
+  ///        `c_str::basic_shm_builder<char>`.
+  typedef basic_shm_builder<char> shm_builder;
+
+} // namespace c_str
+
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#endif
+
+#endif // include guard
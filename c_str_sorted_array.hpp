@@ -0,0 +1,416 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str_sorted_array.hpp
+/// @brief     Sorted arrays of C-strings for interfaces with `bsearch`/`strcmp`
+///            semantics, sorted and searched using cached lengths and prefix
+///            keys.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C++20.
+
+#ifndef C_STR_SORTED_ARRAY_0D8B4E62_93A7_4C1F_B5E0_6A27C9F13D84_1_0
+/// @cond _NO_DOC_
+#define C_STR_SORTED_ARRAY_0D8B4E62_93A7_4C1F_B5E0_6A27C9F13D84_1_0
+/// @endcond
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "c_str_builder.hpp"
+
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wc++98-compat" // C++20 is required anyway
+#elif defined(_MSC_VER)
+#  pragma warning(push)
+#  pragma warning(disable : 4710 4711) // functions may or may not be inlined
+#endif
+
+namespace c_str
+{
+
+  /// @brief Concept to ensure `ElemT` provides a null-terminated sequence of
+  ///        `CharT` elements without a copy (a `c_str::basic_builder`, an
+  ///        object with a `c_str()` member function, a pointer and a
+  ///        `c_str::null_sentinel_t`, or a pointer to a C-string).
+  template<class ElemT, class CharT>
+  concept terminated_element_of_type =
+    terminated_string_like_of_type<ElemT, CharT> ||
+    null_terminated_range_of_type<ElemT, CharT> ||
+    std::is_null_pointer_v<ElemT> ||
+    (std::is_pointer_v<ElemT> && std::convertible_to<ElemT, const CharT *>);
+
+  /// @brief Determines whether `c_str::basic_sorted_c_str_array` refers to
+  ///        the C-strings of the elements, or packs copies of them.
+  enum class sorted_storage : bool
+  {
+    reference, ///< refer to the C-strings of the elements
+    pack ///< copy the C-strings in sorted order into one contiguous buffer
+  };
+
+  /// @brief The `c_str::basic_sorted_c_str_array` class template sorts the
+  ///        C-strings of a collection into an array of pointers, as expected
+  ///        by C interfaces using `bsearch` with a `strcmp` comparator.
+  ///
+  /// The order is that of `std::char_traits<CharT>::compare()` (the order of
+  /// `strcmp` for `char`). Sorting pointers with a `strcmp` comparator is
+  /// dominated by dereferencing the pointers. Thus, the length of every
+  /// string is determined once, and 8 bytes of the string are cached as an
+  /// integral key whose order is the order of the characters. Like the first
+  /// pass of an MSD radix sort, the keys begin behind the longest prefix
+  /// common to all strings (e.g. a common directory of paths). Most
+  /// comparisons are decided by the keys. Only strings with equal keys are
+  /// compared beyond them. <br>
+  /// The keys and lengths are kept in a contiguous array, which
+  /// `lower_bound()` and `find()` search in the same way. With
+  /// `c_str::sorted_storage::pack`, copies of the strings are placed
+  /// contiguously in sorted order, so neighboring strings share cache lines
+  /// and the elements don't need to outlive the array. Otherwise, like the
+  /// pointers provided by a `c_str::basic_builder`, the pointers are only
+  /// valid as long as the elements exist and are not modified. Objects are
+  /// movable, but not copyable. <br>
+  /// The strings must not contain embedded null characters. A null pointer is
+  /// sorted as zero-length string.
+  /// @code
+  ///   const c_str::sorted_c_str_array table{ names, c_str::sorted_storage::pack };
+  ///   legacy_register(table.data(), table.size()); // bsearch with strcmp
+  ///   const bool known{ table.find(std::string_view{ "name" }) != table.end() };
+  /// @endcode
+  /// @tparam CharT  Value type of the characters.
+  template<common_char_type CharT>
+  class basic_sorted_c_str_array
+  {
+  public:
+    /// @brief Character type of the `CharT` template parameter.
+    using value_type = CharT;
+
+    /// @brief Type of the provided pointers to the C-strings.
+    using const_pointer = const value_type *;
+
+    /// @brief Type of sizes and indexes.
+    using size_type = std::size_t;
+
+    /// @brief Type of the iterators over the C-string pointers.
+    using const_iterator = const const_pointer *;
+
+  private:
+    using _traits_type = std::char_traits<value_type>;
+
+    // number of characters in the prefix key
+    static constexpr size_type _m_prefix_chars{ sizeof(std::uint64_t) / sizeof(value_type) };
+
+    static constexpr value_type _m_zero{};
+
+    struct _key_type
+    {
+      std::uint64_t prefix; // first characters, most significant first, padded with zeros
+      size_type length;
+    };
+
+    struct _entry_type
+    {
+      _key_type key;
+      const_pointer ptr;
+    };
+
+    std::vector<_key_type> _m_keys{};
+    std::vector<const_pointer> _m_ptrs{}; // followed by a null pointer
+    std::vector<value_type> _m_packed{};
+    size_type _m_common{}; // length of the prefix common to all strings, the keys begin behind it
+
+    // character as unsigned value in the order of `_traits_type::lt()`, which compares `char` as `unsigned char`
+    static constexpr std::uint64_t _order_of(const value_type ch) noexcept
+    {
+      using unsigned_type = std::make_unsigned_t<value_type>;
+      if constexpr (std::is_signed_v<value_type> && !std::is_same_v<value_type, char>)
+        return static_cast<unsigned_type>(static_cast<unsigned_type>(ch) ^ (unsigned_type{ 1 } << (sizeof(value_type) * 8 - 1)));
+      else
+        return static_cast<unsigned_type>(ch);
+    }
+
+    // key of the characters behind the common prefix of length `common`
+    static constexpr _key_type _key_of(const const_pointer str, const size_type length, const size_type common) noexcept
+    {
+      const auto count{ (std::min)(length - common, _m_prefix_chars) };
+      std::uint64_t prefix{};
+      for (size_type idx{}; idx < count; ++idx)
+        prefix |= _order_of(str[common + idx]) << ((_m_prefix_chars - 1 - idx) * 8 * sizeof(value_type));
+
+      return { prefix, length };
+    }
+
+    // three-way comparison of strings sharing the common prefix, equal prefix keys imply equal characters up to the shorter length
+    static int _compare(const _key_type &lhsKey, const const_pointer lhs, const _key_type &rhsKey, const const_pointer rhs, const size_type common) noexcept
+    {
+      if (lhsKey.prefix != rhsKey.prefix)
+        return lhsKey.prefix < rhsKey.prefix ? -1 : 1;
+
+      if (const auto skip{ common + _m_prefix_chars }, count{ (std::min)(lhsKey.length, rhsKey.length) }; count > skip)
+        if (const auto result{ _traits_type::compare(lhs + skip, rhs + skip, count - skip) })
+          return result;
+
+      return lhsKey.length < rhsKey.length ? -1 : static_cast<int>(lhsKey.length > rhsKey.length);
+    }
+
+    template<class ElemT>
+    static const_pointer _ptr_of(const ElemT &elem) noexcept
+    {
+      if constexpr (std::is_null_pointer_v<ElemT>)
+        return std::addressof(_m_zero);
+      else if constexpr (std::is_pointer_v<ElemT>)
+        return elem ? static_cast<const_pointer>(elem) : std::addressof(_m_zero);
+      else if constexpr (terminated_string_like_of_type<ElemT, value_type>)
+        return elem.c_str();
+      else
+        return static_cast<const_pointer>(elem.begin());
+    }
+
+    template<class SortT, class RangeT>
+    void _build(const SortT &sort, const RangeT &range, const sorted_storage storage)
+    {
+      std::vector<_entry_type> entries{};
+      if constexpr (std::ranges::sized_range<RangeT>)
+        entries.reserve(static_cast<size_type>(std::ranges::size(range)));
+
+      for (const auto &elem : range)
+      {
+        const auto ptr{ _ptr_of(elem) };
+        entries.push_back({ { 0, _traits_type::length(ptr) }, ptr });
+      }
+
+      if (!entries.empty())
+      {
+        const auto first{ entries.front().ptr };
+        _m_common = entries.front().key.length;
+        for (const auto &entry : entries)
+        {
+          _m_common = (std::min)(_m_common, entry.key.length);
+          size_type idx{};
+          while (idx < _m_common && entry.ptr[idx] == first[idx])
+            ++idx;
+
+          _m_common = idx;
+        }
+
+        for (auto &entry : entries)
+          entry.key = _key_of(entry.ptr, entry.key.length, _m_common);
+      }
+
+      sort(entries.begin(), entries.end(), [common = _m_common](const _entry_type &lhs, const _entry_type &rhs) noexcept {
+        return _compare(lhs.key, lhs.ptr, rhs.key, rhs.ptr, common) < 0;
+      });
+
+      if (storage == sorted_storage::pack)
+      {
+        size_type packedSize{};
+        for (const auto &entry : entries)
+          packedSize += entry.key.length + 1;
+
+        _m_packed.resize(packedSize);
+        auto dest{ _m_packed.data() };
+        for (auto &entry : entries)
+        {
+          _traits_type::copy(dest, entry.ptr, entry.key.length + 1);
+          entry.ptr = dest;
+          dest += entry.key.length + 1;
+        }
+      }
+
+      _m_keys.reserve(entries.size());
+      _m_ptrs.reserve(entries.size() + 1);
+      for (const auto &entry : entries)
+      {
+        _m_keys.push_back(entry.key);
+        _m_ptrs.push_back(entry.ptr);
+      }
+
+      _m_ptrs.push_back(nullptr);
+    }
+
+  public:
+    /// @brief Default constructor that creates an empty array.
+    basic_sorted_c_str_array() : _m_ptrs(1)
+    {
+    }
+
+    /// @brief Sort the C-strings of the elements of a collection.
+    /// @tparam RangeT  Type of the collection, an input range of
+    ///                 `c_str::basic_builder` objects, other null-terminated
+    ///                 strings, or pointers to C-strings.
+    /// @param range    Collection of C-strings.
+    /// @param storage  `c_str::sorted_storage::pack` to copy the strings into
+    ///                 a contiguous buffer in sorted order.
+    template<std::ranges::input_range RangeT>
+    explicit basic_sorted_c_str_array(const RangeT &range, const sorted_storage storage = sorted_storage::reference)
+      requires terminated_element_of_type<std::ranges::range_value_t<RangeT>, value_type>
+    {
+      _build([](auto first, auto last, auto comp) { std::sort(first, last, comp); }, range, storage);
+    }
+
+    /// @brief Sort the C-strings of the elements of a collection using an
+    ///        execution policy.
+    /// @tparam ExecPolicyT  Type of the execution policy, like
+    ///                      `std::execution::parallel_policy`.
+    /// @tparam RangeT       Type of the collection, an input range of
+    ///                      `c_str::basic_builder` objects, other
+    ///                      null-terminated strings, or pointers to C-strings.
+    /// @param policy   Execution policy of the sort, like
+    ///                 `std::execution::par`.
+    /// @param range    Collection of C-strings.
+    /// @param storage  `c_str::sorted_storage::pack` to copy the strings into
+    ///                 a contiguous buffer in sorted order.
+    template<class ExecPolicyT, std::ranges::input_range RangeT>
+    basic_sorted_c_str_array(ExecPolicyT &&policy, const RangeT &range, const sorted_storage storage = sorted_storage::reference)
+      requires std::is_execution_policy_v<std::remove_cvref_t<ExecPolicyT>> && terminated_element_of_type<std::ranges::range_value_t<RangeT>, value_type>
+    {
+      _build([&policy](auto first, auto last, auto comp) { std::sort(policy, first, last, comp); }, range, storage);
+    }
+
+    basic_sorted_c_str_array(const basic_sorted_c_str_array &) = delete;
+    basic_sorted_c_str_array &operator=(const basic_sorted_c_str_array &) = delete;
+
+    /// @brief Move constructor. The pointers to packed strings remain valid.
+    basic_sorted_c_str_array(basic_sorted_c_str_array &&other) noexcept = default;
+
+    /// @brief Move assignment operator. The pointers to packed strings remain
+    ///        valid.
+    basic_sorted_c_str_array &operator=(basic_sorted_c_str_array &&other) noexcept = default;
+
+    /// @brief Destructor.
+    ~basic_sorted_c_str_array() = default;
+
+    /// @brief Provides the sorted array of C-string pointers, followed by a
+    ///        null pointer.
+    const const_pointer *data() const noexcept
+    {
+      return _m_ptrs.data();
+    }
+
+    /// @brief Number of C-strings.
+    size_type size() const noexcept
+    {
+      return _m_keys.size();
+    }
+
+    /// @brief Check whether the array is empty.
+    bool empty() const noexcept
+    {
+      return _m_keys.empty();
+    }
+
+    /// @brief Provides the C-string at index `idx`.
+    const_pointer operator[](const size_type idx) const noexcept
+    {
+      return _m_ptrs[idx];
+    }
+
+    /// @brief Provides the length of the C-string at index `idx`.
+    size_type length(const size_type idx) const noexcept
+    {
+      return _m_keys[idx].length;
+    }
+
+    /// @brief Iterator to the first C-string pointer.
+    const_iterator begin() const noexcept
+    {
+      return _m_ptrs.data();
+    }
+
+    /// @brief Iterator behind the last C-string pointer.
+    const_iterator end() const noexcept
+    {
+      return _m_ptrs.data() + _m_keys.size();
+    }
+
+    /// @brief Checks whether the strings are packed into a contiguous buffer.
+    bool is_packed() const noexcept
+    {
+      return !_m_packed.empty();
+    }
+
+    /// @brief Searches the first C-string that is not less than `str`.
+    /// @param str  A `c_str::basic_builder`, a pointer to a C-string, or an
+    ///             object convertible to `std::basic_string_view<CharT>`,
+    ///             which doesn't need to be null-terminated.
+    /// @return Iterator to the C-string pointer, or `end()`.
+    template<class StrT>
+    const_iterator lower_bound(const StrT &str) const noexcept
+    {
+      const auto view{ transparent_hash<value_type>::_view_of(str) };
+      if (empty())
+        return begin();
+
+      if (const auto result{ _traits_type::compare(view.data(), _m_ptrs.front(), (std::min)(view.size(), _m_common)) }; result || view.size() < _m_common)
+        return result > 0 ? end() : begin(); // doesn't share the common prefix
+
+      const auto key{ _key_of(view.data(), view.size(), _m_common) };
+      size_type first{};
+      size_type count{ _m_keys.size() };
+      while (count)
+      {
+        const auto half{ count / 2 };
+        if (_compare(_m_keys[first + half], _m_ptrs[first + half], key, view.data(), _m_common) < 0)
+        {
+          first += half + 1;
+          count -= half + 1;
+        }
+        else
+          count = half;
+      }
+
+      return begin() + first;
+    }
+
+    /// @brief Searches a C-string equal to `str`.
+    /// @param str  A `c_str::basic_builder`, a pointer to a C-string, or an
+    ///             object convertible to `std::basic_string_view<CharT>`,
+    ///             which doesn't need to be null-terminated.
+    /// @return Iterator to the C-string pointer, or `end()`.
+    template<class StrT>
+    const_iterator find(const StrT &str) const noexcept
+    {
+      const auto found{ lower_bound(str) };
+      if (found == end())
+        return found;
+
+      const auto view{ transparent_hash<value_type>::_view_of(str) };
+      const auto &key{ _m_keys[static_cast<size_type>(found - begin())] };
+      return key.length == view.size() && !_traits_type::compare(*found, view.data(), view.size()) ? found : end();
+    }
+
+    /// @brief Number of bytes held by the keys, the pointer array, and the
+    ///        packed strings.
+    size_type owned_bytes() const noexcept
+    {
+      return _m_keys.capacity() * sizeof(_key_type) + _m_ptrs.capacity() * sizeof(const_pointer) + _m_packed.capacity() * sizeof(value_type);
+    }
+  };
+
+  /// @brief `c_str::sorted_c_str_array` is a type definition for
+  ///        `c_str::basic_sorted_c_str_array<char>`.
+  typedef basic_sorted_c_str_array<char> sorted_c_str_array;
+
+  /// @brief `c_str::wsorted_c_str_array` is a type definition for
+  ///        `c_str::basic_sorted_c_str_array<wchar_t>`.
+  typedef basic_sorted_c_str_array<wchar_t> wsorted_c_str_array;
+
+} // namespace c_str
+
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#elif defined(_MSC_VER)
+#  pragma warning(pop)
+#endif
+
+#endif // include guard
@@ -0,0 +1,350 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str_static_string_map.hpp
+/// @brief     Map of string literals to values, using a perfect hash function
+///            computed at compile time.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C++20.
+
+#ifndef C_STR_STATIC_STRING_MAP_5B9E2A17_C6D3_4F08_A14B_83D7E0F6C259_1_0
+/// @cond _NO_DOC_
+#define C_STR_STATIC_STRING_MAP_5B9E2A17_C6D3_4F08_A14B_83D7E0F6C259_1_0
+/// @endcond
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "c_str_builder.hpp"
+
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wc++98-compat" // C++20 is required anyway
+#elif defined(_MSC_VER)
+#  pragma warning(push)
+#  pragma warning(disable : 4710 4711) // functions may or may not be inlined
+#endif
+
+namespace c_str
+{
+
+  /// @cond _NO_DOC_
+  namespace _static_map
+  {
+    constexpr std::uint64_t mix(std::uint64_t value) noexcept
+    {
+      value ^= value >> 32;
+      value *= 0xD6E8FEB86659FD93U;
+      value ^= value >> 32;
+      value *= 0xD6E8FEB86659FD93U;
+      return value ^ (value >> 32);
+    }
+
+    // up to 8 bytes of characters, in the order of a little-endian load
+    template<class CharT>
+    constexpr std::uint64_t load(const CharT *const str, const std::size_t count) noexcept
+    {
+      constexpr auto word{ sizeof(std::uint64_t) / sizeof(CharT) };
+      if constexpr (std::endian::native == std::endian::little)
+      {
+        if (!std::is_constant_evaluated() && count == word)
+        {
+          std::uint64_t value{};
+          std::memcpy(&value, str, sizeof(value));
+          return value;
+        }
+      }
+
+      std::uint64_t value{};
+      for (std::size_t idx{}; idx < count; ++idx)
+        value |= static_cast<std::uint64_t>(static_cast<std::make_unsigned_t<CharT>>(str[idx])) << (idx * 8 * sizeof(CharT));
+
+      return value;
+    }
+
+    // hash of the length and all characters, 8 bytes at a time; every step is a bijection of the state, so keys of the same length never collide
+    template<class CharT>
+    constexpr std::uint64_t key_hash(const std::basic_string_view<CharT> str) noexcept
+    {
+      constexpr auto word{ sizeof(std::uint64_t) / sizeof(CharT) };
+      const auto len{ str.size() };
+      auto hash{ static_cast<std::uint64_t>(len) * 0x9E3779B97F4A7C15U };
+      for (std::size_t pos{}; pos < len; pos += word)
+        hash = std::rotl((hash ^ load(str.data() + pos, len - pos < word ? len - pos : word)) * 0xFF51AFD7ED558CCDU, 29);
+
+      return mix(hash);
+    }
+
+    constexpr std::size_t slot_of(const std::uint64_t hash, const std::uint32_t seed, const std::size_t slotCount) noexcept
+    {
+      return static_cast<std::size_t>(mix(hash + seed * 0x9E3779B97F4A7C15U)) & (slotCount - 1);
+    }
+  } // namespace _static_map
+  /// @endcond
+
+  /// @brief The `c_str::basic_static_string_map` class template maps a fixed
+  ///        set of keys, known at compile time, to values.
+  ///
+  /// Objects are created at compile time by `c_str::make_static_string_map()`
+  /// from string literals, which are null-terminated and never copied. The
+  /// constructor searches a perfect hash function over the length and the
+  /// characters of the keys, read 8 bytes at a time ("hash and displace": the
+  /// keys are distributed to buckets, and a seed is searched per bucket that
+  /// places its keys into free slots). A lookup computes the hash, reads one slot, and
+  /// confirms the key by comparing the length and calling
+  /// `std::char_traits<CharT>::compare()` once, which is a vectorized `memcmp`
+  /// for `char`. This replaces chains of `strcmp` calls. <br>
+  /// Lookups accept `c_str::basic_builder` objects, pointers to C-strings,
+  /// and objects convertible to `std::basic_string_view<CharT>`, which don't
+  /// need to be null-terminated. For a pointer, the length is determined
+  /// first. A null pointer is never found, not even if the map contains an
+  /// empty key. <br>
+  /// Different keys of the same length always have different hashes. Keys of
+  /// different lengths whose 64-bit hashes happen to collide are rejected.
+  /// @code
+  ///   constexpr auto commands{ c_str::make_static_string_map<int>({ { "open", 1 }, { "close", 2 }, { "read", 3 } }) };
+  ///   extern "C" void on_command(const char *name)
+  ///   {
+  ///     if (const auto cmd{ commands.find(name) })
+  ///       dispatch(*cmd);
+  ///   }
+  /// @endcode
+  /// @tparam CharT   Value type of the characters.
+  /// @tparam ValueT  Type of the mapped values, a literal type.
+  /// @tparam Count   Number of keys.
+  template<common_char_type CharT, class ValueT, std::size_t Count>
+  class basic_static_string_map
+  {
+  public:
+    /// @brief Character type of the `CharT` template parameter.
+    using char_type = CharT;
+
+    /// @brief Type of the keys.
+    using key_type = std::basic_string_view<char_type>;
+
+    /// @brief Type of the mapped values.
+    using mapped_type = ValueT;
+
+    /// @brief Type of the key-value pairs.
+    using value_type = std::pair<key_type, mapped_type>;
+
+    /// @brief Type of sizes.
+    using size_type = std::size_t;
+
+    /// @brief Type of the iterators over the key-value pairs, in the order
+    ///        they were passed to the constructor.
+    using const_iterator = const value_type *;
+
+  private:
+    using _traits_type = std::char_traits<char_type>;
+
+    static constexpr size_type _m_bucket_count{ std::bit_ceil(Count ? Count : 1) };
+    static constexpr size_type _m_slot_count{ 2 * _m_bucket_count };
+    static constexpr std::uint32_t _m_no_entry{ 0xFFFFFFFFU };
+    static constexpr std::uint32_t _m_max_seed{ 0x10000U };
+
+    static_assert(Count < _m_no_entry, "Too many keys.");
+
+    std::array<value_type, Count> _m_entries{};
+    std::array<std::uint32_t, _m_bucket_count> _m_seeds{};
+    std::array<std::uint32_t, _m_slot_count> _m_slots{}; // index of the entry, or `_m_no_entry`
+
+    static constexpr size_type _bucket_of(const std::uint64_t hash) noexcept
+    {
+      return static_cast<size_type>(hash >> 32) & (_m_bucket_count - 1);
+    }
+
+    template<class StrT>
+    constexpr const value_type *_find(const StrT &key) const noexcept
+    {
+      if constexpr (std::is_null_pointer_v<StrT>)
+        return nullptr;
+      else
+      {
+        if constexpr (std::is_pointer_v<StrT>)
+        {
+          if (!key)
+            return nullptr;
+        }
+        else if constexpr (requires { { key.get() } -> std::convertible_to<const char_type *>; })
+        {
+          if (!key.get()) // `c_str::basic_builder` constructed from a null pointer
+            return nullptr;
+        }
+
+        return _lookup(transparent_hash<char_type>::_view_of(key));
+      }
+    }
+
+    constexpr const value_type *_lookup(const key_type key) const noexcept
+    {
+      const auto hash{ _static_map::key_hash(key) };
+      const auto idx{ _m_slots[_static_map::slot_of(hash, _m_seeds[_bucket_of(hash)], _m_slot_count)] };
+      if (idx == _m_no_entry)
+        return nullptr;
+
+      const auto &entry{ _m_entries[idx] };
+      return entry.first.size() == key.size() && !_traits_type::compare(entry.first.data(), key.data(), key.size()) ? std::addressof(entry) : nullptr;
+    }
+
+  public:
+    /// @brief Constructor computing the perfect hash function of the keys.
+    ///        Use `c_str::make_static_string_map()`.
+    /// @param entries  Key-value pairs.
+    /// @throw std::invalid_argument if keys are equal or cannot be
+    ///        distinguished by the hash function. The throw makes the
+    ///        initialization ill-formed.
+    consteval explicit basic_static_string_map(const value_type (&entries)[Count])
+    {
+      std::array<std::uint64_t, Count> hashes{};
+      std::array<size_type, Count> order{}; // entry indexes, grouped by bucket, larger buckets first
+      std::array<size_type, _m_bucket_count> bucketSizes{};
+      for (size_type idx{}; idx < Count; ++idx)
+      {
+        _m_entries[idx] = entries[idx];
+        hashes[idx] = _static_map::key_hash(entries[idx].first);
+        ++bucketSizes[_bucket_of(hashes[idx])];
+        order[idx] = idx;
+      }
+
+      std::sort(order.begin(), order.end(), [&](const size_type lhs, const size_type rhs) {
+        const auto lhsBucket{ _bucket_of(hashes[lhs]) };
+        const auto rhsBucket{ _bucket_of(hashes[rhs]) };
+        if (bucketSizes[lhsBucket] != bucketSizes[rhsBucket])
+          return bucketSizes[lhsBucket] > bucketSizes[rhsBucket];
+
+        return lhsBucket != rhsBucket ? lhsBucket < rhsBucket : hashes[lhs] < hashes[rhs];
+      });
+
+      for (size_type pos{ 1 }; pos < Count; ++pos) // equal hashes are adjacent now
+        if (hashes[order[pos - 1]] == hashes[order[pos]])
+          throw std::invalid_argument{ entries[order[pos - 1]].first == entries[order[pos]].first ?
+                                         "c_str::basic_static_string_map: duplicate key" :
+                                         "c_str::basic_static_string_map: keys with colliding hashes" };
+
+      _m_slots.fill(_m_no_entry);
+      for (size_type first{}; first < Count;)
+      {
+        const auto bucket{ _bucket_of(hashes[order[first]]) };
+        auto last{ first + 1 };
+        while (last < Count && _bucket_of(hashes[order[last]]) == bucket)
+          ++last;
+
+        std::uint32_t seed{};
+        for (;; ++seed)
+        {
+          if (seed == _m_max_seed)
+            throw std::invalid_argument{ "c_str::basic_static_string_map: no perfect hash function found" };
+
+          bool placed{ true };
+          for (auto pos{ first }; placed && pos < last; ++pos)
+          {
+            const auto slot{ _static_map::slot_of(hashes[order[pos]], seed, _m_slot_count) };
+            placed = _m_slots[slot] == _m_no_entry;
+            for (auto prev{ first }; placed && prev < pos; ++prev)
+              placed = _static_map::slot_of(hashes[order[prev]], seed, _m_slot_count) != slot;
+          }
+
+          if (placed)
+            break;
+        }
+
+        _m_seeds[bucket] = seed;
+        for (auto pos{ first }; pos < last; ++pos)
+          _m_slots[_static_map::slot_of(hashes[order[pos]], seed, _m_slot_count)] = static_cast<std::uint32_t>(order[pos]);
+
+        first = last;
+      }
+    }
+
+    /// @brief Looks up the value mapped to a key.
+    /// @param key  A `c_str::basic_builder`, a pointer to a C-string, or an
+    ///             object convertible to `std::basic_string_view<CharT>`.
+    /// @return Pointer to the mapped value, or a null pointer if the key is
+    ///         not in the map.
+    template<class StrT>
+    constexpr const mapped_type *find(const StrT &key) const noexcept
+    {
+      const auto entry{ _find(key) };
+      return entry ? std::addressof(entry->second) : nullptr;
+    }
+
+    /// @brief Checks whether the map contains a key.
+    /// @param key  A `c_str::basic_builder`, a pointer to a C-string, or an
+    ///             object convertible to `std::basic_string_view<CharT>`.
+    template<class StrT>
+    constexpr bool contains(const StrT &key) const noexcept
+    {
+      return _find(key) != nullptr;
+    }
+
+    /// @brief Provides the value mapped to a key.
+    /// @param key  A `c_str::basic_builder`, a pointer to a C-string, or an
+    ///             object convertible to `std::basic_string_view<CharT>`.
+    /// @return Reference to the mapped value.
+    /// @throw std::out_of_range if the key is not in the map.
+    template<class StrT>
+    constexpr const mapped_type &at(const StrT &key) const
+    {
+      const auto value{ find(key) };
+      if (!value)
+        throw std::out_of_range{ "c_str::basic_static_string_map: key not found" };
+
+      return *value;
+    }
+
+    /// @brief Number of keys.
+    static constexpr size_type size() noexcept
+    {
+      return Count;
+    }
+
+    /// @brief Iterator to the first key-value pair.
+    constexpr const_iterator begin() const noexcept
+    {
+      return _m_entries.data();
+    }
+
+    /// @brief Iterator behind the last key-value pair.
+    constexpr const_iterator end() const noexcept
+    {
+      return _m_entries.data() + Count;
+    }
+  };
+
+  /// @brief Specialization of `c_str::basic_static_string_map` for `char`.
+  template<class ValueT, std::size_t Count>
+  using static_string_map = basic_static_string_map<char, ValueT, Count>;
+
+  /// @brief The `c_str::make_static_string_map()` function template creates a
+  ///        `c_str::basic_static_string_map` object at compile time.
+  /// @tparam ValueT  Type of the mapped values.
+  /// @tparam CharT   Value type of the characters.
+  /// @param entries  Key-value pairs, usually string literals and constants.
+  /// @return `c_str::basic_static_string_map` object.
+  template<class ValueT, common_char_type CharT = char, std::size_t Count>
+  consteval basic_static_string_map<CharT, ValueT, Count> make_static_string_map(const std::pair<std::basic_string_view<CharT>, ValueT> (&entries)[Count])
+  {
+    return basic_static_string_map<CharT, ValueT, Count>{ entries };
+  }
+
+} // namespace c_str
+
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#elif defined(_MSC_VER)
+#  pragma warning(pop)
+#endif
+
+#endif // include guard
@@ -0,0 +1,444 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str_template_builder.hpp
+/// @brief     Precompiled string templates whose placeholders are filled in a
+///            single write pass, optionally into a reused buffer.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C++20.
+
+#ifndef C_STR_TEMPLATE_BUILDER_3D6A0C58_92F4_4B1E_A7C3_E18B5F2D9064_1_0
+/// @cond _NO_DOC_
+#define C_STR_TEMPLATE_BUILDER_3D6A0C58_92F4_4B1E_A7C3_E18B5F2D9064_1_0
+/// @endcond
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "c_str_builder.hpp"
+
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wc++98-compat" // C++20 is required anyway
+#elif defined(_MSC_VER)
+#  pragma warning(push)
+#  pragma warning(disable : 4710 4711) // functions may or may not be inlined
+#endif
+
+namespace c_str
+{
+
+  /// @brief Concept to ensure `ArgT` can fill a placeholder of a template of
+  ///        `CharT` elements. These are objects convertible to
+  ///        `std::basic_string_view<CharT>`, objects with a `view()` member
+  ///        function (like `c_str::basic_builder`), and integers.
+  template<class ArgT, class CharT>
+  concept template_argument_of_type =
+    std::convertible_to<const ArgT &, std::basic_string_view<CharT>> ||
+    requires(const ArgT &arg) { { arg.view() } -> std::convertible_to<std::basic_string_view<CharT>>; } ||
+    (std::integral<ArgT> && !std::same_as<ArgT, bool> && !common_char_type<ArgT>);
+
+  /// @cond _NO_DOC_
+  namespace _template
+  {
+    // calls `onText` for every fixed character and `onHole` for every `{}` placeholder, `{{` and `}}` denote literal braces
+    template<class CharT, class TextT, class HoleT>
+    constexpr void parse(const std::basic_string_view<CharT> pattern, TextT onText, HoleT onHole)
+    {
+      for (std::size_t idx{}; idx < pattern.size(); ++idx)
+      {
+        const auto ch{ pattern[idx] };
+        const auto next{ idx + 1 < pattern.size() ? pattern[idx + 1] : CharT{} };
+        if (ch == CharT{ '{' } && next == CharT{ '}' })
+          onHole();
+        else if ((ch == CharT{ '{' } || ch == CharT{ '}' }) && next == ch)
+          onText(ch);
+        else if (ch == CharT{ '{' } || ch == CharT{ '}' })
+          throw std::invalid_argument{ "c_str::template_builder: a brace is neither part of a {} placeholder nor doubled" };
+        else
+        {
+          onText(ch);
+          continue;
+        }
+
+        ++idx; // the second character of the pair is consumed
+      }
+    }
+
+    // character sequence of a placeholder argument, integers are formatted into the object
+    template<class CharT>
+    class argument
+    {
+      CharT _m_digits[24]{};
+      std::basic_string_view<CharT> _m_view{};
+
+    public:
+      template<class ArgT>
+      constexpr argument(const ArgT &arg) noexcept
+      {
+        if constexpr (std::convertible_to<const ArgT &, std::basic_string_view<CharT>>)
+          _m_view = arg;
+        else if constexpr (requires { { arg.view() } -> std::convertible_to<std::basic_string_view<CharT>>; })
+          _m_view = arg.view();
+        else
+        {
+          char digits[sizeof(_m_digits)]{};
+          const auto end{ std::to_chars(digits, digits + sizeof(digits), arg).ptr }; // 24 characters fit any integer of up to 64 bits
+          const auto count{ static_cast<std::size_t>(end - digits) };
+          for (std::size_t idx{}; idx < count; ++idx)
+            _m_digits[idx] = static_cast<CharT>(digits[idx]);
+
+          _m_view = { _m_digits, count };
+        }
+      }
+
+      argument(const argument &) = delete;
+      argument &operator=(const argument &) = delete;
+
+      constexpr std::basic_string_view<CharT> view() const noexcept
+      {
+        return _m_view;
+      }
+    };
+
+    // writes the segments and the arguments in turn
+    template<class CharT>
+    constexpr void write(CharT *dest, const CharT *const text, const std::size_t *const ends, const std::size_t segments, const argument<CharT> *const args) noexcept
+    {
+      std::size_t begin{};
+      for (std::size_t idx{}; idx < segments; ++idx)
+      {
+        std::char_traits<CharT>::copy(dest, text + begin, ends[idx] - begin);
+        dest += ends[idx] - begin;
+        begin = ends[idx];
+        if (idx + 1 < segments)
+        {
+          const auto arg{ args[idx].view() };
+          std::char_traits<CharT>::copy(dest, arg.data(), arg.size());
+          dest += arg.size();
+        }
+      }
+    }
+
+    [[noreturn]] inline void throw_count_mismatch()
+    {
+      throw std::invalid_argument{ "c_str::template_builder: the number of arguments doesn't match the number of placeholders" };
+    }
+  } // namespace _template
+  /// @endcond
+
+  /// @brief The `c_str::basic_compiled_template` class template is a string
+  ///        template with `{}` placeholders, compiled from a literal at compile
+  ///        time.
+  ///
+  /// The placeholders are resolved once, during compilation. The fixed
+  /// characters are stored without the placeholders, along with the end
+  /// offsets of the fixed segments. `{{` and `}}` denote literal braces, any
+  /// other brace fails the compilation.
+  /// @code
+  ///   static constexpr c_str::basic_compiled_template dbPath{ "/var/lib/svc/{}/{}.db" };
+  ///   const auto csb{ dbPath.build(tenant, id) };
+  /// @endcode
+  /// @tparam CharT  Value type of the characters.
+  /// @tparam Size   Size of the literal, including its terminating null.
+  template<common_char_type CharT, std::size_t Size>
+  class basic_compiled_template
+  {
+  public:
+    /// @brief Character type of the `CharT` template parameter.
+    using value_type = CharT;
+
+    /// @brief Type of lengths and sizes.
+    using size_type = std::size_t;
+
+  private:
+    value_type _m_text[Size]{}; // fixed characters, without placeholders
+    size_type _m_ends[Size / 2 + 1]{}; // end offset of each fixed segment in `_m_text`, a placeholder consists of at least 2 characters
+    size_type _m_segments{};
+
+  public:
+    /// @brief Compiles the template at compile time.
+    /// @param pattern  String literal of the template.
+    consteval basic_compiled_template(const value_type (&pattern)[Size])
+    {
+      if (pattern[Size - 1] != value_type{})
+        throw std::invalid_argument{ "c_str::basic_compiled_template: the pattern is not a string literal" };
+
+      size_type length{};
+      _template::parse(std::basic_string_view<value_type>{ pattern, Size - 1 }, [this, &length](const value_type ch) { _m_text[length++] = ch; }, [this, &length] { _m_ends[_m_segments++] = length; });
+      _m_ends[_m_segments++] = length;
+    }
+
+    /// @brief Provides the number of placeholders.
+    constexpr size_type holes() const noexcept
+    {
+      return _m_segments - 1;
+    }
+
+    /// @brief Provides the number of fixed characters.
+    constexpr size_type fixed_length() const noexcept
+    {
+      return _m_ends[_m_segments - 1];
+    }
+
+    /// @brief Provides the fixed characters, without placeholders.
+    constexpr const value_type *text() const noexcept
+    {
+      return _m_text;
+    }
+
+    /// @brief Provides the end offsets of the `holes() + 1` fixed segments in
+    ///        `text()`.
+    constexpr const size_type *segment_ends() const noexcept
+    {
+      return _m_ends;
+    }
+
+    /// @brief Creates a `c_str::basic_builder` object with the placeholders
+    ///        filled by `args`.
+    ///
+    /// The total length is computed first, and the string is written once into
+    /// the owned buffer of the object (see `c_str::basic_builder::for_overwrite()`).
+    /// @tparam BuilderT  Type of the created object.
+    /// @param args  One argument for each placeholder.
+    /// @return `BuilderT` object owning the C-string.
+    /// @throw std::invalid_argument if the number of arguments doesn't match
+    ///        the number of placeholders.
+    template<class BuilderT = basic_builder<value_type>, template_argument_of_type<value_type>... ArgsT>
+    BuilderT build(const ArgsT &...args) const
+    {
+      if (sizeof...(ArgsT) != holes())
+        _template::throw_count_mismatch();
+
+      const _template::argument<value_type> views[sizeof...(ArgsT) + 1]{ args..., std::basic_string_view<value_type>{} };
+      size_type length{ fixed_length() };
+      for (size_type idx{}; idx < sizeof...(ArgsT); ++idx)
+        length += views[idx].view().size();
+
+      return BuilderT::for_overwrite(length, [this, &views, length](value_type *const dest) noexcept {
+        _template::write(dest, _m_text, _m_ends, _m_segments, views);
+        return length;
+      });
+    }
+  };
+
+  /// @brief The `c_str::basic_template_builder` class template fills the `{}`
+  ///        placeholders of a string template into a reused buffer.
+  ///
+  /// The template is either compiled at runtime from a string-like object, or
+  /// copied from a `c_str::basic_compiled_template` without parsing. The
+  /// lengths of the arguments are kept between the calls of `fill()`. As long
+  /// as they don't change, only the arguments are written, and the fixed
+  /// segments remain in place. Otherwise, everything from the first
+  /// placeholder with a changed length is rewritten. The buffer is only
+  /// reallocated if the string gets longer than ever before. `{{` and `}}`
+  /// denote literal braces.
+  /// @code
+  ///   c_str::template_builder cmd{ c_str::basic_compiled_template{ "convert {} -resize {}x{} {}" } };
+  ///   for (const auto &image : images)
+  ///     std::system(cmd.fill(image.src, image.width, image.height, image.dest));
+  /// @endcode
+  /// @tparam CharT       Value type of the characters.
+  /// @tparam AllocatorT  Allocator type used to allocate the buffer.
+  template<common_char_type CharT, class AllocatorT = std::allocator<CharT>>
+  class basic_template_builder
+  {
+  public:
+    /// @brief Character type of the `CharT` template parameter.
+    using value_type = CharT;
+
+    /// @brief Type of lengths and sizes.
+    using size_type = std::size_t;
+
+    /// @brief Type of the provided pointer.
+    using const_pointer = const value_type *;
+
+  private:
+    using _size_allocator_type = typename std::allocator_traits<AllocatorT>::template rebind_alloc<size_type>;
+
+    basic_owned_buffer<value_type, AllocatorT> _m_text{}; // fixed characters, without placeholders
+    std::vector<size_type, _size_allocator_type> _m_ends{}; // end offset of each fixed segment in `_m_text`
+    std::vector<size_type, _size_allocator_type> _m_lengths{}; // lengths of the arguments of the last `fill()`
+    basic_owned_buffer<value_type, AllocatorT> _m_buf{}; // the filled template
+    bool _m_filled{};
+
+    // checks whether an argument refers into the reused buffer, e.g. the view of a previous `fill()`
+    bool _aliases(const std::basic_string_view<value_type> arg) const noexcept
+    {
+      const std::less<const value_type *> less{}; // total order, even for pointers into unrelated objects
+      return !arg.empty() && _m_buf.data() && !less(arg.data(), _m_buf.data()) && less(arg.data(), _m_buf.data() + _m_buf.capacity());
+    }
+
+  public:
+    /// @brief Compiles a template at runtime.
+    /// @param pattern  Template, convertible to `std::basic_string_view`.
+    /// @throw std::invalid_argument if a brace is neither part of a `{}`
+    ///        placeholder nor doubled.
+    explicit basic_template_builder(const std::basic_string_view<value_type> pattern)
+    {
+      _m_text.reserve(pattern.size());
+      _template::parse(pattern, [this](const value_type ch) { _m_text.push_back(ch); }, [this] { _m_ends.push_back(_m_text.size()); });
+      _m_ends.push_back(_m_text.size());
+      _m_lengths.resize(_m_ends.size() - 1);
+    }
+
+    /// @brief Takes a template compiled at compile time.
+    /// @param compiled  `c_str::basic_compiled_template` object.
+    template<size_type Size>
+    explicit basic_template_builder(const basic_compiled_template<value_type, Size> &compiled) :
+      _m_ends(compiled.segment_ends(), compiled.segment_ends() + compiled.holes() + 1),
+      _m_lengths(compiled.holes())
+    {
+      _m_text.assign(compiled.text(), compiled.fixed_length());
+    }
+
+    /// @brief Provides the number of placeholders.
+    size_type holes() const noexcept
+    {
+      return _m_lengths.size();
+    }
+
+    /// @brief Fills the placeholders.
+    ///
+    /// Arguments may refer to the C-string of the previous `fill()`. The
+    /// string is then written into a new buffer, as if the lengths of all
+    /// arguments had changed.
+    /// @param args  One argument for each placeholder.
+    /// @return Pointer to the filled C-string, valid until the next call of
+    ///         `fill()` or the destruction of the object.
+    /// @throw std::invalid_argument if the number of arguments doesn't match
+    ///        the number of placeholders.
+    template<template_argument_of_type<value_type>... ArgsT>
+    const_pointer fill(const ArgsT &...args)
+    {
+      if (sizeof...(ArgsT) != holes())
+        _template::throw_count_mismatch();
+
+      const _template::argument<value_type> views[sizeof...(ArgsT) + 1]{ args..., std::basic_string_view<value_type>{} };
+      size_type length{ _m_text.size() };
+      auto aliased{ false };
+      for (size_type idx{}; idx < sizeof...(ArgsT); ++idx)
+      {
+        length += views[idx].view().size();
+        aliased = aliased || _aliases(views[idx].view());
+      }
+
+      if (aliased) [[unlikely]] // writing in place would overwrite the argument, or growing would release it
+      {
+        basic_owned_buffer<value_type, AllocatorT> fresh{ _m_buf.get_allocator() };
+        fresh.resize_and_overwrite(length, [this, &views](value_type *const dest, const size_type count) noexcept {
+          _template::write(dest, _m_text.c_str(), _m_ends.data(), _m_ends.size(), views);
+          return count;
+        });
+        for (size_type idx{}; idx < sizeof...(ArgsT); ++idx)
+          _m_lengths[idx] = views[idx].view().size();
+
+        _m_buf.swap(fresh);
+        _m_filled = true;
+        return _m_buf.c_str();
+      }
+
+      _m_buf.resize_and_overwrite(length, [this, &views](value_type *const dest, const size_type count) noexcept { // the previous content is kept
+        const auto text{ _m_text.c_str() };
+        auto shifted{ !_m_filled }; // the fixed segments are written from the first placeholder with a changed length on
+        size_type begin{};
+        size_type pos{};
+        for (size_type idx{}; idx < _m_ends.size(); ++idx)
+        {
+          const auto segmentLength{ _m_ends[idx] - begin };
+          if (shifted)
+            std::char_traits<value_type>::copy(dest + pos, text + begin, segmentLength);
+
+          pos += segmentLength;
+          begin = _m_ends[idx];
+          if (idx == _m_lengths.size())
+            break;
+
+          const auto arg{ views[idx].view() };
+          if (arg.size() != _m_lengths[idx])
+          {
+            shifted = true;
+            _m_lengths[idx] = arg.size();
+          }
+
+          std::char_traits<value_type>::copy(dest + pos, arg.data(), arg.size());
+          pos += arg.size();
+        }
+
+        return count;
+      });
+      _m_filled = true;
+      return _m_buf.c_str();
+    }
+
+    /// @brief Provides the C-string of the last `fill()`, or a zero-length
+    ///        string.
+    const_pointer get() const noexcept
+    {
+      return _m_buf.c_str();
+    }
+
+    /// @brief Provides the length of the C-string of the last `fill()`.
+    size_type length() const noexcept
+    {
+      return _m_buf.size();
+    }
+
+    /// @brief Provides a `std::basic_string_view` of the C-string of the last
+    ///        `fill()`.
+    std::basic_string_view<value_type> view() const noexcept
+    {
+      return { get(), length() };
+    }
+
+    /// @brief Creates a `c_str::basic_builder` object with the placeholders
+    ///        filled by `args`, without using the reused buffer.
+    /// @tparam BuilderT  Type of the created object.
+    /// @param args  One argument for each placeholder.
+    /// @return `BuilderT` object owning the C-string.
+    /// @throw std::invalid_argument if the number of arguments doesn't match
+    ///        the number of placeholders.
+    template<class BuilderT = basic_builder<value_type>, template_argument_of_type<value_type>... ArgsT>
+    BuilderT build(const ArgsT &...args) const
+    {
+      if (sizeof...(ArgsT) != holes())
+        _template::throw_count_mismatch();
+
+      const _template::argument<value_type> views[sizeof...(ArgsT) + 1]{ args..., std::basic_string_view<value_type>{} };
+      size_type length{ _m_text.size() };
+      for (size_type idx{}; idx < sizeof...(ArgsT); ++idx)
+        length += views[idx].view().size();
+
+      return BuilderT::for_overwrite(length, [this, &views, length](value_type *const dest) noexcept {
+        _template::write(dest, _m_text.c_str(), _m_ends.data(), _m_ends.size(), views);
+        return length;
+      });
+    }
+  };
+
+  /// @brief `c_str::template_builder` is a type definition for
+  ///        `c_str::basic_template_builder<char>`.
+  typedef basic_template_builder<char> template_builder;
+
+  /// @brief `c_str::wtemplate_builder` is a type definition for
+  ///        `c_str::basic_template_builder<wchar_t>`.
+  typedef basic_template_builder<wchar_t> wtemplate_builder;
+
+} // namespace c_str
+
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#elif defined(_MSC_VER)
+#  pragma warning(pop)
+#endif
+
+#endif // include guard
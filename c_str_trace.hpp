@@ -0,0 +1,361 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str_trace.hpp
+/// @brief     File format of recorded `c_str::basic_builder` workloads, and the
+///            recorder capturing them if the `C_STR_BUILDER_TRACE` macro is
+///            defined.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C++20.
+
+#ifndef C_STR_TRACE_7C04D9B2_5E1A_4F63_9A8D_2B6E0F31C7A4_1_0
+/// @cond _NO_DOC_
+#define C_STR_TRACE_7C04D9B2_5E1A_4F63_9A8D_2B6E0F31C7A4_1_0
+/// @endcond
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+#include "c_str_builder.hpp"
+#ifdef C_STR_BUILDER_TRACE
+#  include <atomic>
+#  include <chrono>
+#  include <mutex>
+#  include <thread>
+#  include <unordered_map>
+#endif
+
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wc++98-compat" // C++20 is required anyway
+#elif defined(_MSC_VER)
+#  pragma warning(push)
+#  pragma warning(disable : 4710 4711) // functions may or may not be inlined
+#endif
+
+namespace c_str
+{
+
+  /// @brief Value of `c_str::trace_record::other` if there is no other
+  ///        object involved.
+  inline constexpr std::uint32_t trace_no_object{ 0xFFFFFFFFU };
+
+  /// @brief Record of a trace file, describing one operation on a
+  ///        `c_str::basic_builder` object.
+  ///
+  /// Objects are identified by slot numbers rather than addresses. A slot is
+  /// occupied from a `construct`, `copy_construct`, or `move_construct`
+  /// record until the `destroy` record of the object, and may be reused
+  /// afterwards. The lifetime of an object is the time between these records.
+  /// Slots are counted per character size, and the objects of a copy, move,
+  /// or swap always have the same character type.
+  struct trace_record
+  {
+    std::uint64_t time_ns; ///< nanoseconds since the capture started
+    std::uint64_t length; ///< length of the C-string after the operation
+    std::uint32_t object; ///< slot of the object
+    std::uint32_t other; ///< slot of the other object, or `c_str::trace_no_object`
+    std::uint16_t thread; ///< index of the thread in the order of their first event
+    trace_op op; ///< operation
+    trace_source source; ///< kind of the source
+    std::uint8_t char_size; ///< size of the character type in bytes
+    std::uint8_t terminated; ///< 0 if the object owns a copy of the C-string, 1 otherwise
+    std::uint8_t reserved[2]; ///< zero
+  };
+
+  static_assert(sizeof(trace_record) == 32, "the trace file format requires 32-byte records");
+
+  /// @cond _NO_DOC_
+  namespace _trace_file
+  {
+    inline constexpr char magic[8]{ 'C', 'S', 'T', 'R', 'T', 'R', 'C', '\x01' }; // 1 is the format version
+
+    struct file_closer
+    {
+      void operator()(std::FILE *const file) const noexcept
+      {
+        static_cast<void>(std::fclose(file));
+      }
+    };
+
+    using file_ptr = std::unique_ptr<std::FILE, file_closer>;
+
+    [[noreturn]] inline void throw_errno(const char *const what)
+    {
+      throw std::system_error{ errno, std::generic_category(), what };
+    }
+  } // namespace _trace_file
+  /// @endcond
+
+  /// @brief The `c_str::write_trace()` function writes trace records to a
+  ///        file.
+  ///
+  /// The file consists of an 8-byte signature followed by the records in host
+  /// byte order.
+  /// @param path     Path of the file to be created or overwritten.
+  /// @param records  Records to be written.
+  /// @throw std::system_error if the file cannot be written.
+  inline void write_trace(const char *const path, const std::span<const trace_record> records)
+  {
+    const _trace_file::file_ptr file{ std::fopen(path, "wb") };
+    if (!file)
+      _trace_file::throw_errno("c_str::write_trace: creating the file failed");
+
+    if (std::fwrite(_trace_file::magic, sizeof(_trace_file::magic), 1, file.get()) != 1 ||
+        std::fwrite(records.data(), sizeof(trace_record), records.size(), file.get()) != records.size() ||
+        std::fflush(file.get()))
+      _trace_file::throw_errno("c_str::write_trace: writing the file failed");
+  }
+
+  /// @brief The `c_str::read_trace()` function reads the trace records of a
+  ///        file written by `c_str::write_trace()`.
+  /// @param path  Path of the file.
+  /// @return Vector of the trace records.
+  /// @throw std::system_error if the file cannot be read. <br>
+  ///        std::runtime_error if the file is not a trace file of this format
+  ///        version.
+  inline std::vector<trace_record> read_trace(const char *const path)
+  {
+    const _trace_file::file_ptr file{ std::fopen(path, "rb") };
+    if (!file)
+      _trace_file::throw_errno("c_str::read_trace: opening the file failed");
+
+    char magic[sizeof(_trace_file::magic)]{};
+    if (std::fread(magic, sizeof(magic), 1, file.get()) != 1 || std::memcmp(magic, _trace_file::magic, sizeof(magic)))
+      throw std::runtime_error{ "c_str::read_trace: not a trace file of a supported version" };
+
+    std::vector<trace_record> records{};
+    trace_record record{};
+    while (std::fread(std::addressof(record), sizeof(record), 1, file.get()) == 1)
+      records.push_back(record);
+
+    if (std::ferror(file.get()))
+      _trace_file::throw_errno("c_str::read_trace: reading the file failed");
+
+    return records;
+  }
+
+#ifdef C_STR_BUILDER_TRACE
+  /// @brief The `c_str::trace_recorder` class captures the operations on all
+  ///        `c_str::basic_builder` objects of the program as
+  ///        `c_str::trace_record` records.
+  ///
+  /// It requires the `C_STR_BUILDER_TRACE` macro to be defined in all
+  /// translation units (see @ref Trace). While recording, it is installed as
+  /// `c_str::trace_hook`, and the events of all threads are serialized. Only
+  /// one recorder can record at a time. Objects that already existed when the
+  /// recording started get a slot when they are referenced first, their
+  /// destruction is not recorded. If memory for a record cannot be allocated,
+  /// the event is dropped and counted.
+  /// @code
+  ///   c_str::trace_recorder recorder{};
+  ///   recorder.start();
+  ///   run_workload();
+  ///   recorder.stop();
+  ///   c_str::write_trace("workload.trace", recorder.records());
+  /// @endcode
+  class trace_recorder
+  {
+  public:
+    /// @brief Type of sizes.
+    using size_type = std::size_t;
+
+  private:
+    static inline std::atomic<trace_recorder *> _m_active{};
+    static inline std::atomic<size_type> _m_in_flight{}; // number of hook calls that may still access a recorder
+
+    mutable std::mutex _m_mutex{};
+    std::vector<trace_record> _m_records{};
+    std::unordered_map<const void *, std::uint32_t> _m_slots{}; // addresses of the live objects
+    std::vector<std::uint32_t> _m_free_slots[5]{}; // released slots, per character size 1, 2, and 4
+    std::uint32_t _m_slot_count[5]{}; // number of slots, per character size
+    std::unordered_map<std::thread::id, std::uint16_t> _m_threads{};
+    std::chrono::steady_clock::time_point _m_start{};
+    size_type _m_dropped{};
+
+    std::uint32_t _new_slot(const void *const object, const std::uint8_t charSize)
+    {
+      auto &freeSlots{ _m_free_slots[charSize] };
+      std::uint32_t slot{};
+      if (freeSlots.empty())
+        slot = _m_slot_count[charSize]++;
+      else
+      {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+      }
+
+      _m_slots.insert_or_assign(object, slot);
+      return slot;
+    }
+
+    std::uint32_t _slot_of(const void *const object, const std::uint8_t charSize)
+    {
+      const auto found{ _m_slots.find(object) };
+      return found != _m_slots.end() ? found->second : _new_slot(object, charSize); // an object that existed before the recording started
+    }
+
+    void _record(const trace_event &event)
+    {
+      const auto time{ std::chrono::steady_clock::now() - _m_start };
+      trace_record record{};
+      record.time_ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+      record.length = static_cast<std::uint64_t>(event.length);
+      record.other = trace_no_object;
+      record.op = event.op;
+      record.source = event.source;
+      record.char_size = event.char_size;
+      record.terminated = event.terminated ? 1U : 0U;
+      record.thread = _m_threads.try_emplace(std::this_thread::get_id(), static_cast<std::uint16_t>(_m_threads.size())).first->second;
+      if (_m_records.size() == _m_records.capacity())
+        _m_records.reserve(_m_records.empty() ? 4096 : 2 * _m_records.size()); // don't allocate after the slots are updated
+      switch (event.op)
+      {
+        case trace_op::construct:
+        case trace_op::copy_construct:
+        case trace_op::move_construct:
+          if (event.other)
+            record.other = _slot_of(event.other, event.char_size);
+
+          record.object = _new_slot(event.object, event.char_size);
+          break;
+        case trace_op::destroy:
+        {
+          const auto found{ _m_slots.find(event.object) };
+          if (found == _m_slots.end())
+            return; // constructed before the recording started
+
+          record.object = found->second;
+          _m_free_slots[event.char_size].reserve(_m_slot_count[event.char_size]);
+          _m_free_slots[event.char_size].push_back(found->second);
+          _m_slots.erase(found);
+          break;
+        }
+        default:
+          record.object = _slot_of(event.object, event.char_size);
+          if (event.other)
+            record.other = _slot_of(event.other, event.char_size);
+      }
+
+      _m_records.push_back(record);
+    }
+
+    struct _in_flight_guard
+    {
+      _in_flight_guard() noexcept
+      {
+        _m_in_flight.fetch_add(1, std::memory_order_seq_cst); // registered before the recorder is loaded, see stop()
+      }
+
+      _in_flight_guard(const _in_flight_guard &) = delete;
+      _in_flight_guard &operator=(const _in_flight_guard &) = delete;
+
+      ~_in_flight_guard()
+      {
+        _m_in_flight.fetch_sub(1, std::memory_order_release);
+      }
+    };
+
+    static void _hook(const trace_event &event) noexcept
+    {
+      const _in_flight_guard guard{};
+      const auto recorder{ _m_active.load(std::memory_order_seq_cst) };
+      if (!recorder)
+        return;
+
+      const std::lock_guard lock{ recorder->_m_mutex };
+      try
+      {
+        recorder->_record(event);
+      }
+      catch (...)
+      {
+        ++recorder->_m_dropped;
+      }
+    }
+
+  public:
+    /// @brief Default constructor. The recording starts with `start()`.
+    trace_recorder() = default;
+
+    trace_recorder(const trace_recorder &) = delete;
+    trace_recorder &operator=(const trace_recorder &) = delete;
+
+    /// @brief Destructor, stops the recording.
+    ~trace_recorder()
+    {
+      stop();
+    }
+
+    /// @brief Discards previous records and starts the recording.
+    /// @throw std::logic_error if a recorder is already recording.
+    void start()
+    {
+      trace_recorder *expected{};
+      if (!_m_active.compare_exchange_strong(expected, this, std::memory_order_acq_rel))
+        throw std::logic_error{ "c_str::trace_recorder: a recorder is already recording" };
+
+      {
+        const std::lock_guard lock{ _m_mutex };
+        _m_records.clear();
+        _m_slots.clear();
+        for (auto &freeSlots : _m_free_slots)
+          freeSlots.clear();
+
+        for (auto &slotCount : _m_slot_count)
+          slotCount = 0;
+
+        _m_threads.clear();
+        _m_dropped = 0;
+        _m_start = std::chrono::steady_clock::now();
+      }
+
+      trace_hook.store(_hook, std::memory_order_release);
+    }
+
+    /// @brief Stops the recording and waits until the events in progress are
+    ///        recorded. The records are kept.
+    void stop() noexcept
+    {
+      trace_recorder *expected{ this };
+      if (_m_active.compare_exchange_strong(expected, nullptr, std::memory_order_seq_cst))
+        trace_hook.store(nullptr, std::memory_order_release);
+
+      // a hook call either loads the null pointer or is counted here, so no hook call refers to this recorder afterwards
+      while (_m_in_flight.load(std::memory_order_seq_cst) != 0)
+        std::this_thread::yield();
+    }
+
+    /// @brief Provides the records. Must not be called while recording.
+    std::span<const trace_record> records() const noexcept
+    {
+      return _m_records;
+    }
+
+    /// @brief Provides the number of events dropped due to a lack of memory.
+    size_type dropped() const noexcept
+    {
+      const std::lock_guard lock{ _m_mutex };
+      return _m_dropped;
+    }
+  };
+#endif
+
+} // namespace c_str
+
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#elif defined(_MSC_VER)
+#  pragma warning(pop)
+#endif
+
+#endif // include guard
@@ -0,0 +1,416 @@
+/// @copyright Copyright (c) 2023 Steffen Illhardt,
+///            licensed under the MIT license
+///            ( https://opensource.org/license/mit/ ).
+/// @file      c_str_unescape.hpp
+/// @brief     Builders decoding JSON escapes, percent-encoding, and C escapes
+///            directly into the terminated string buffer.
+/// @version   1.0
+/// @author    Steffen Illhardt
+/// @date      2023
+/// @pre       Requires compiler support for at least C++20.
+
+#ifndef C_STR_UNESCAPE_5F7E8E0D_16C9_4A6D_87F9_CCEADA2F1654_1_0
+/// @cond _NO_DOC_
+#define C_STR_UNESCAPE_5F7E8E0D_16C9_4A6D_87F9_CCEADA2F1654_1_0
+/// @endcond
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "c_str_builder.hpp"
+
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wc++98-compat" // C++20 is required anyway
+#elif defined(_MSC_VER)
+#  pragma warning(push)
+#  pragma warning(disable : 4710 4711) // functions may or may not be inlined
+#endif
+
+namespace c_str
+{
+
+  /// @brief First template parameter of `c_str::basic_unescape_builder`
+  ///        specifying the encoding of the source string.
+  enum class escaping
+  {
+    json, ///< JSON string escapes (`\"`, `\\`, `\/`, `\b`, `\f`, `\n`, `\r`, `\t`, `\uXXXX`)
+    percent, ///< percent-encoding of URIs (`%XX`)
+    form, ///< percent-encoding of HTML forms, where `+` also encodes a space
+    c_language ///< escape sequences of C string literals (including octal, `\x`, `\u`, and `\U` escapes)
+  };
+
+  /// @brief The `c_str::basic_unescape_builder` class template provides the
+  ///        decoded C-string of an escaped or percent-encoded string-like
+  ///        object.
+  ///
+  /// The source is scanned for the first escape character using
+  /// `std::char_traits::find()` (typically a vectorized `memchr()`). If the
+  /// source doesn't contain any escape sequence, the object is constructed
+  /// exactly like a `c_str::basic_builder`, i.e. a null-terminated source is
+  /// not copied. Otherwise the source is decoded directly into the owned
+  /// string buffer, where escape-free runs are copied as a whole. In form
+  /// mode, the `+` characters are searched the same way and replaced in the
+  /// copied runs. Decoding never makes a string longer, so the buffer is
+  /// allocated only once. <br>
+  /// Unicode escapes are encoded as UTF-8. Malformed escape sequences (like
+  /// an invalid hexadecimal digit or an unpaired surrogate) cause a
+  /// `std::invalid_argument` exception. Decoded null characters are kept in
+  /// the owned buffer, but the C-string ends at the first of them, i.e.
+  /// `length()` and `view()` don't include them and the following
+  /// characters.
+  ///
+  /// @tparam Escaping      Value of the `c_str::escaping` enumeration.
+  /// @tparam CharT         Value type of the characters, `char` or `char8_t`.
+  /// @tparam NullBehavior  Value of the `c_str::if_null` enumeration. See
+  ///                       @ref NullBehavior.
+  /// @tparam AllocatorT    Allocator type used to allocate the owned string
+  ///                       buffer.
+  template<escaping Escaping, common_char_type CharT = char, if_null NullBehavior = if_null::DEF_NULL_BEHAVIOR, class AllocatorT = std::allocator<CharT>>
+  class basic_unescape_builder : public basic_builder<CharT, NullBehavior, AllocatorT>
+  {
+    static_assert(sizeof(CharT) == 1, "The unescape builders decode into UTF-8 code units.");
+
+    using _base_type = basic_builder<CharT, NullBehavior, AllocatorT>;
+
+  public:
+    /// @brief Character type of the `CharT` template parameter.
+    using value_type = CharT;
+
+    /// @brief Type of lengths and sizes.
+    using size_type = std::size_t;
+
+    /// @brief Value of the `Escaping` template parameter.
+    static constexpr escaping escaping_type{ Escaping };
+
+  private:
+    using _traits_type = std::char_traits<value_type>;
+
+    static constexpr value_type _escape_char{ escaping_type == escaping::percent || escaping_type == escaping::form ? value_type{ '%' } : value_type{ '\\' } };
+
+    [[noreturn]] static void _throw_malformed()
+    {
+      throw std::invalid_argument{ "c_str::basic_unescape_builder: malformed escape sequence" };
+    }
+
+    static constexpr const value_type *_find_escape(const value_type *const first, const value_type *const last) noexcept
+    {
+      const auto found{ _traits_type::find(first, static_cast<size_type>(last - first), _escape_char) };
+      return found ? found : last;
+    }
+
+    static constexpr bool _has_escape(const value_type *const first, const value_type *const last) noexcept
+    {
+      if constexpr (escaping_type == escaping::form)
+        return _find_escape(first, last) != last || _traits_type::find(first, static_cast<size_type>(last - first), value_type{ '+' });
+      else
+        return _find_escape(first, last) != last;
+    }
+
+    // replaces the `+` characters of a copied run with spaces (form mode), the run is searched like the source
+    static constexpr void _plus_to_space(value_type *first, value_type *const last) noexcept
+    {
+      while (const auto found{ _traits_type::find(first, static_cast<size_type>(last - first), value_type{ '+' }) })
+      {
+        first += found - first; // the non-const pointer to the found character
+        _traits_type::assign(*first++, value_type{ ' ' });
+      }
+    }
+
+    static constexpr unsigned _hex_value(const value_type ch) noexcept
+    {
+      return ch >= value_type{ '0' } && ch <= value_type{ '9' } ? static_cast<unsigned>(ch - value_type{ '0' }) :
+             ch >= value_type{ 'a' } && ch <= value_type{ 'f' } ? static_cast<unsigned>(ch - value_type{ 'a' }) + 10U :
+             ch >= value_type{ 'A' } && ch <= value_type{ 'F' } ? static_cast<unsigned>(ch - value_type{ 'A' }) + 10U :
+                                                                  16U; // not a hexadecimal digit
+    }
+
+    // reads exactly `digits` hexadecimal digits
+    static constexpr std::uint32_t _read_hex(const value_type *&it, const value_type *const last, const unsigned digits)
+    {
+      if (last - it < static_cast<std::ptrdiff_t>(digits))
+        _throw_malformed();
+
+      std::uint32_t value{};
+      for (unsigned idx{}; idx < digits; ++idx, ++it)
+      {
+        const auto digit{ _hex_value(*it) };
+        if (digit > 15U)
+          _throw_malformed();
+
+        value = value << 4 | digit;
+      }
+
+      return value;
+    }
+
+    static constexpr value_type *_put_utf8(value_type *dest, const std::uint32_t codePoint)
+    {
+      if (codePoint > 0x10FFFFU || (codePoint >= 0xD800U && codePoint <= 0xDFFFU))
+        _throw_malformed();
+
+      if (codePoint < 0x80U)
+        *dest++ = static_cast<value_type>(codePoint);
+      else if (codePoint < 0x800U)
+      {
+        *dest++ = static_cast<value_type>(0xC0U | codePoint >> 6);
+        *dest++ = static_cast<value_type>(0x80U | (codePoint & 0x3FU));
+      }
+      else if (codePoint < 0x10000U)
+      {
+        *dest++ = static_cast<value_type>(0xE0U | codePoint >> 12);
+        *dest++ = static_cast<value_type>(0x80U | (codePoint >> 6 & 0x3FU));
+        *dest++ = static_cast<value_type>(0x80U | (codePoint & 0x3FU));
+      }
+      else
+      {
+        *dest++ = static_cast<value_type>(0xF0U | codePoint >> 18);
+        *dest++ = static_cast<value_type>(0x80U | (codePoint >> 12 & 0x3FU));
+        *dest++ = static_cast<value_type>(0x80U | (codePoint >> 6 & 0x3FU));
+        *dest++ = static_cast<value_type>(0x80U | (codePoint & 0x3FU));
+      }
+
+      return dest;
+    }
+
+    // decodes the escape sequence at `it` (pointing to the escape character), advances `it` behind it
+    static constexpr value_type *_decode_escape(const value_type *&it, const value_type *const last, value_type *dest)
+    {
+      if constexpr (escaping_type == escaping::percent || escaping_type == escaping::form)
+      {
+        ++it;
+        *dest++ = static_cast<value_type>(_read_hex(it, last, 2));
+        return dest;
+      }
+      else
+      {
+        if (++it == last)
+          _throw_malformed();
+
+        const auto ch{ *it++ };
+        switch (ch)
+        {
+          case value_type{ '"' }:
+          case value_type{ '\\' }:
+            *dest++ = ch;
+            return dest;
+          case value_type{ 'b' }:
+            *dest++ = value_type{ '\b' };
+            return dest;
+          case value_type{ 'f' }:
+            *dest++ = value_type{ '\f' };
+            return dest;
+          case value_type{ 'n' }:
+            *dest++ = value_type{ '\n' };
+            return dest;
+          case value_type{ 'r' }:
+            *dest++ = value_type{ '\r' };
+            return dest;
+          case value_type{ 't' }:
+            *dest++ = value_type{ '\t' };
+            return dest;
+          case value_type{ 'u' }:
+          {
+            auto codePoint{ _read_hex(it, last, 4) };
+            if constexpr (escaping_type == escaping::json)
+            {
+              if (codePoint >= 0xD800U && codePoint <= 0xDBFFU) // high surrogate => the low surrogate must follow
+              {
+                if (last - it < 2 || it[0] != value_type{ '\\' } || it[1] != value_type{ 'u' })
+                  _throw_malformed();
+
+                it += 2;
+                const auto lowSurrogate{ _read_hex(it, last, 4) };
+                if (lowSurrogate < 0xDC00U || lowSurrogate > 0xDFFFU)
+                  _throw_malformed();
+
+                codePoint = 0x10000U + ((codePoint - 0xD800U) << 10 | (lowSurrogate - 0xDC00U));
+              }
+            }
+
+            return _put_utf8(dest, codePoint);
+          }
+          default:
+            break;
+        }
+
+        if constexpr (escaping_type == escaping::json)
+        {
+          if (ch != value_type{ '/' })
+            _throw_malformed();
+
+          *dest++ = ch;
+        }
+        else
+        {
+          switch (ch)
+          {
+            case value_type{ '\'' }:
+            case value_type{ '?' }:
+              *dest++ = ch;
+              break;
+            case value_type{ 'a' }:
+              *dest++ = value_type{ '\a' };
+              break;
+            case value_type{ 'v' }:
+              *dest++ = value_type{ '\v' };
+              break;
+            case value_type{ 'U' }:
+              dest = _put_utf8(dest, _read_hex(it, last, 8));
+              break;
+            case value_type{ 'x' }:
+            {
+              if (it == last || _hex_value(*it) > 15U)
+                _throw_malformed();
+
+              std::uint32_t value{};
+              for (; it != last && _hex_value(*it) <= 15U; ++it)
+                if ((value = value << 4 | _hex_value(*it)) > 0xFFU)
+                  _throw_malformed();
+
+              *dest++ = static_cast<value_type>(value);
+              break;
+            }
+            default:
+            {
+              if (ch < value_type{ '0' } || ch > value_type{ '7' })
+                _throw_malformed();
+
+              auto value{ static_cast<std::uint32_t>(ch - value_type{ '0' }) };
+              for (int digits{ 1 }; digits < 3 && it != last && *it >= value_type{ '0' } && *it <= value_type{ '7' }; ++digits, ++it)
+                value = value << 3 | static_cast<std::uint32_t>(*it - value_type{ '0' });
+
+              if (value > 0xFFU)
+                _throw_malformed();
+
+              *dest++ = static_cast<value_type>(value);
+              break;
+            }
+          }
+        }
+
+        return dest;
+      }
+    }
+
+    // decodes [first, last) into `dest`, where `escape` points to the first escape character
+    static constexpr size_type _decode(const value_type *first, const value_type *escape, const value_type *const last, value_type *const dest)
+    {
+      auto out{ dest };
+      for (;;)
+      {
+        _traits_type::copy(out, first, static_cast<size_type>(escape - first)); // escape-free run
+        if constexpr (escaping_type == escaping::form)
+          _plus_to_space(out, out + (escape - first));
+
+        out += escape - first;
+        if (escape == last)
+          return static_cast<size_type>(out - dest);
+
+        out = _decode_escape(escape, last, out);
+        first = escape;
+        escape = _find_escape(first, last);
+      }
+    }
+
+    static constexpr _base_type _unescape(const value_type *const first, const value_type *const last)
+    {
+      const auto escape{ _find_escape(first, last) };
+      return _base_type::for_overwrite(static_cast<size_type>(last - first), [&](value_type *const dest) {
+        return _decode(first, escape, last, dest);
+      });
+    }
+
+    template<class StrLikeT>
+    static constexpr _base_type _make(const StrLikeT &strLike)
+    {
+      if constexpr (std::is_null_pointer_v<StrLikeT>)
+        return _base_type{ strLike };
+      else if constexpr (std::is_pointer_v<StrLikeT> || terminated_string_like_of_type<StrLikeT, value_type> || null_terminated_range_of_type<StrLikeT, value_type>)
+      {
+        const value_type *str{};
+        if constexpr (std::is_pointer_v<StrLikeT>)
+          str = strLike;
+        else if constexpr (terminated_string_like_of_type<StrLikeT, value_type>)
+          str = strLike.c_str();
+        else
+          str = strLike.begin();
+
+        if (!str) // a null pointer is handled by the base class
+          return _base_type{ strLike };
+
+        const auto last{ str + _traits_type::length(str) };
+        return _has_escape(str, last) ? _unescape(str, last) : _base_type{ strLike };
+      }
+      else if constexpr (contiguous_string_like_of_type<StrLikeT, value_type> && requires { std::data(strLike); std::size(strLike); })
+      {
+        const value_type *const first{ std::data(strLike) };
+        auto last{ first + std::size(strLike) };
+        if (first != last && !last[-1]) // a terminating null is not decoded
+          --last;
+
+        return _has_escape(first, last) ? _unescape(first, last) : _base_type{ strLike };
+      }
+      else // not contiguous => copied into a contiguous buffer first
+      {
+        _base_type copy{ strLike };
+        const auto view{ copy.view() };
+        const auto last{ view.data() + view.size() };
+        if (!_has_escape(view.data(), last))
+          return copy; // not copied again, unlike an operand of the conditional operator
+
+        return _unescape(view.data(), last);
+      }
+    }
+
+  public:
+    /// @brief Default constructor that creates an object like it was
+    ///        constructed from `nullptr`.
+    constexpr basic_unescape_builder() = default;
+
+    /// @brief Create a `c_str::basic_unescape_builder` object from an escaped
+    ///        string-like object.
+    /// @tparam StrLikeT  Type of the referenced string-like object, or
+    ///                   `nullptr_t`.
+    /// @param strLike  A string-like object, a null pointer of type `CharT *`
+    ///                 or `nullptr`.
+    /// @throw std::invalid_argument if the object contains a malformed escape
+    ///        sequence.
+    template<class StrLikeT>
+    constexpr basic_unescape_builder(const StrLikeT &strLike)
+      requires std::is_null_pointer_v<StrLikeT> || string_like_of_type<StrLikeT, value_type>
+      :
+      _base_type{ _make(strLike) }
+    {
+    }
+  };
+
+  /// @brief `c_str::json_unescape_builder` is a type definition for
+  ///        `c_str::basic_unescape_builder<c_str::escaping::json>`.
+  typedef basic_unescape_builder<escaping::json> json_unescape_builder;
+
+  /// @brief `c_str::percent_decode_builder` is a type definition for
+  ///        `c_str::basic_unescape_builder<c_str::escaping::percent>`.
+  typedef basic_unescape_builder<escaping::percent> percent_decode_builder;
+
+  /// @brief `c_str::form_decode_builder` is a type definition for
+  ///        `c_str::basic_unescape_builder<c_str::escaping::form>`.
+  typedef basic_unescape_builder<escaping::form> form_decode_builder;
+
+  /// @brief `c_str::c_unescape_builder` is a type definition for
+  ///        `c_str::basic_unescape_builder<c_str::escaping::c_language>`.
+  typedef basic_unescape_builder<escaping::c_language> c_unescape_builder;
+
+} // namespace c_str
+
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#elif defined(_MSC_VER)
+#  pragma warning(pop)
+#endif
+
+#endif // include guard
@@ -1,10 +1,72 @@
 #include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
+#include <list>
+#include <memory>
+#include <new>
+#include <ranges>
 #include <span>
+#include <string>
 #include <string_view>
 #include <vector>
 #include "c_str_builder.hpp"
+// the add-on headers are optional, the tests of a missing one are skipped
+#if __has_include("c_str_accounting_allocator.hpp")
+#  include "c_str_accounting_allocator.hpp"
+#endif
+#if __has_include("c_str_array.hpp")
+#  include <execution>
+#  include "c_str_array.hpp"
+#endif
+#if __has_include("c_str_builder_ref.hpp")
+#  include "c_str_builder_ref.hpp"
+#endif
+#if __has_include("c_str_builder_stream.hpp")
+#  include "c_str_builder_stream.hpp"
+#endif
+#if __has_include("c_str_env_snapshot.hpp")
+#  include "c_str_env_snapshot.hpp"
+#endif
+#if __has_include("c_str_large_page_allocator.hpp")
+#  include "c_str_large_page_allocator.hpp"
+#endif
+#if __has_include("c_str_memo_builder.hpp")
+#  include "c_str_memo_builder.hpp"
+#endif
+#if __has_include("c_str_padded_allocator.hpp")
+#  include "c_str_padded_allocator.hpp"
+#endif
+#if __has_include("c_str_sorted_array.hpp")
+#  include "c_str_sorted_array.hpp"
+#endif
+#if __has_include("c_str_static_string_map.hpp")
+#  include "c_str_static_string_map.hpp"
+#endif
+#if __has_include("c_str_template_builder.hpp")
+#  include "c_str_template_builder.hpp"
+#endif
+#if __has_include("c_str_unescape.hpp")
+#  include "c_str_unescape.hpp"
+#endif
+#if defined(C_STR_BUILDER_TRACE) && __has_include("c_str_trace.hpp")
+#  include <atomic>
+#  include <thread>
+#  include "c_str_trace.hpp"
+#endif
+#ifndef _WIN32
+#  if __has_include("c_str_dir_walker.hpp")
+#    include <fcntl.h>
+#    include <unistd.h>
+#    include "c_str_dir_walker.hpp"
+#  endif
+#  if __has_include("c_str_shm_arena.hpp")
+#    include "c_str_shm_arena.hpp"
+#  endif
+#endif
 
 #if defined(__clang__)
 #  pragma clang diagnostic push
@@ -27,6 +89,17 @@ struct string_like_element<StrLikeT>
   using type = wchar_t;
 };
 
+template<class BuilderT>
+void print_builder(const BuilderT &csb)
+{
+  std::cout << " | pointer: " << static_cast<const void *>(csb.get()) << ", string length: " << csb.length() << '\n';
+}
+
+void print_result(const bool result)
+{
+  std::cout << " | result: " << result << '\n';
+}
+
 template<class StrLikeT, class CharT = typename string_like_element<StrLikeT>::type> // `CharT` is necessary because the character type can't be deduced from `nullptr`
 void print_info(const StrLikeT &string_like)
 {
@@ -46,12 +119,12 @@ void print_info(const StrLikeT &string_like)
   // direct use
   const c_str::basic_builder<CharT> csb{ string_like };
 
-  std::cout << " | pointer: " << static_cast<const void *>(csb.get()) << ", string length: " << csb.length() << '\n';
+  print_builder(csb);
 }
 
 int main()
 {
-  std::cout << "1..15 - test id number\n\nN - resulting pointer of a passed null pointer (same as Z in these tests)\nS - non-owned stack pointer\nZ - shared pointer to a static zero value\nI - owned pointer to the internal std::string buffer\nE - non-owned pointer to an external buffer of a string class\n\n(L) - expected string length\n\n";
+  std::cout << "1..69 - test id number\n\nN - resulting pointer of a passed null pointer (same as Z in these tests)\nS - non-owned stack pointer\nZ - shared pointer to a static zero value\nI - owned pointer to the string buffer of the object (c_str::basic_owned_buffer)\nE - non-owned pointer to an external buffer (of a string class, a directory walker, or the environment)\nC - pointer to a copy held outside of the object (e.g. in a cache or an arena)\nB - boolean result of a check\n\n(L) - expected string length, or expected result of B\n\n";
 
   std::cout << " 1 N (0)";
   print_info(nullptr); // nullptr
@@ -116,9 +189,335 @@ int main()
   const std::string str{ view }; // std::basic_string<char>
   print_info(str);
 
+#ifndef C_STR_BUILDER_SLIM // the slim configuration doesn't include <filesystem>
   std::cout << "17 E (0)";
   const std::filesystem::path path{}; // based on `wchar_t` on Windows, based on `char` on any other OS
   print_info(path);
+#else
+  std::cout << "17 - skipped in the slim configuration\n";
+#endif
+
+  std::cout << "18 I (3)";
+  const std::deque<char> deq{ view.begin(), view.end() }; // std::deque<char>
+  print_info(deq);
+
+  std::cout << "19 I (6)";
+  static constexpr std::array chunks{ view, view }; // std::array<std::string_view, 2>
+  print_info(chunks | std::views::join); // std::ranges::join_view<std::ranges::ref_view<const std::array<std::string_view, 2>>>
+
+  std::cout << "20 E (3)";
+  const std::ranges::subrange ntrange{ str.c_str(), c_str::null_sentinel }; // std::ranges::subrange<const char *, c_str::null_sentinel_t>
+  print_info(ntrange);
+
+#if __has_include("c_str_large_page_allocator.hpp")
+  std::cout << "21 I (3)";
+  print_builder(c_str::basic_large_builder<char>{ view }); // c_str::basic_builder<char, c_str::if_null::DEF_NULL_BEHAVIOR, c_str::large_page_allocator<char>>, a short string is kept in the small-string buffer
+
+  std::cout << "22 I (2097152)";
+  const std::vector<char> largevec(2097152, 'A'); // std::vector<char> exceeding C_STR_LARGE_COPY_THRESHOLD, copied by the large-copy tier into a mapped buffer
+  print_builder(c_str::basic_large_builder<char>{ largevec });
+#else
+  std::cout << "21 - skipped, c_str_large_page_allocator.hpp is not available\n22 - skipped, c_str_large_page_allocator.hpp is not available\n";
+#endif
+
+#if __has_include("c_str_padded_allocator.hpp")
+  std::cout << "23 I (3)";
+  const c_str::padded_builder padded{ view }; // c_str::basic_builder<char, c_str::if_null::DEF_NULL_BEHAVIOR, c_str::padded_allocator<char>>
+  print_builder(padded);
+
+  std::cout << "24 B (1)";
+  print_result(padded.has_safe_padding(64) && padded.is_aligned(64)); // 64 zero bytes behind the terminating null, aligned to the size of a cache line
+#else
+  std::cout << "23 - skipped, c_str_padded_allocator.hpp is not available\n24 - skipped, c_str_padded_allocator.hpp is not available\n";
+#endif
+
+  std::cout << "25 I (3)";
+  const std::list<char> lst{ view.begin(), view.end() }; // std::list<char>, copied by a loop rather than by std::ranges algorithms in the slim configuration
+  print_info(lst);
+
+  std::cout << "26 E (3)";
+  const std::wstring wstr{ L"ABC" }; // std::basic_string<wchar_t>, the constructor of c_str::wbuilder is explicitly instantiated in c_str_builder.cpp if C_STR_BUILDER_EXTERN_TEMPLATES is defined
+  print_info(wstr);
+
+  std::cout << "27 B (1)";
+  const c_str::builder cmpcopy{ view }; // owned copy of a std::string_view
+  print_result(cmpcopy == "ABC" && cmpcopy == str && cmpcopy > std::string_view{ "ABB" } && cmpcopy == c_str::builder{ strlit }); // compared with a string literal, a std::string, a std::string_view, and a non-owning builder
+
+  std::cout << "28 B (1)";
+  print_result(std::hash<c_str::builder>{}(cmpcopy) == std::hash<std::string_view>{}(view) && c_str::transparent_hash<>{}(strlit) == std::hash<std::string_view>{}(view)); // hash values equal those of std::string_view
+
+  const std::vector<char> longvec(300, 'A'); // std::vector<char> longer than the max_length of the cache, copied like by c_str::builder
+#if __has_include("c_str_memo_builder.hpp")
+  std::cout << "29 C (3)";
+  print_builder(c_str::memo_builder{ view }); // copy of the std::string_view taken from the per-thread c_str::basic_memo_cache<char>
+
+  std::cout << "30 C (3)";
+  print_builder(c_str::memo_builder{ view }); // same pointer as 29, the cached copy is reused
+
+  std::cout << "31 I (300)";
+  print_builder(c_str::memo_builder{ longvec });
+#else
+  std::cout << "29 - skipped, c_str_memo_builder.hpp is not available\n30 - skipped, c_str_memo_builder.hpp is not available\n31 - skipped, c_str_memo_builder.hpp is not available\n";
+#endif
+
+#if __has_include("c_str_accounting_allocator.hpp")
+  std::cout << "32 I (300)";
+  const c_str::accounted_builder accounted{ longvec }; // c_str::basic_builder<char, c_str::if_null::DEF_NULL_BEHAVIOR, c_str::accounting_allocator<char>>, too long for the small-string buffer
+  print_builder(accounted);
+
+  std::cout << "33 B (1)";
+  print_result(c_str::memory_account<char>::live_buffers() == 1 && c_str::memory_account<char>::live_bytes() == accounted.owned_bytes()); // the owned buffer is charged to the account
+#else
+  std::cout << "32 - skipped, c_str_accounting_allocator.hpp is not available\n33 - skipped, c_str_accounting_allocator.hpp is not available\n";
+#endif
+
+#if !defined(_WIN32) && __has_include("c_str_dir_walker.hpp")
+  char walkroot[]{ "/tmp/c_str_tests_XXXXXX" };
+  if (::mkdtemp(walkroot))
+  {
+    const std::string walkfile{ std::string{ walkroot } + "/ABC" };
+    ::close(::open(walkfile.c_str(), O_CREAT | O_WRONLY, 0600));
+    {
+      c_str::dir_walker walker{ walkroot };
+      std::cout << "34 E (" << walkfile.size() << ')';
+      print_info(*walker.begin()); // c_str::dir_walker::entry, referring to the reused path buffer of the walker
+    }
+
+    ::unlink(walkfile.c_str());
+    ::rmdir(walkroot);
+  }
+#else
+  std::cout << "34 - skipped on Windows, or c_str_dir_walker.hpp is not available\n";
+#endif
+
+#if __has_include("c_str_array.hpp")
+  std::cout << "35 C (3)";
+  const c_str::c_str_array chunkarr{ chunks }; // copies of the std::string_view elements in the blob of the array
+  print_info(chunkarr[1]);
+
+  std::cout << "36 E (3)";
+  const std::vector<std::string> strvec{ str }; // std::vector<std::string>, the null-terminated elements are referenced
+  const c_str::c_str_array strarr{ strvec };
+  print_info(strarr[0]);
+
+  std::cout << "37 C (2)";
+  static constexpr std::array<std::int32_t, 3> coloffsets{ 0, 3, 5 }; // offsets buffer of a columnar string buffer with the values "ABC" and "DE"
+  const c_str::terminated_column column{ coloffsets, std::span{ std::data("ABCDE"), 5 } };
+  print_info(column.c_str(1));
+
+  std::cout << "38 C (2)";
+  print_info(c_str::c_str_array::from_columns(column.offsets(), column.data())[1]); // same pointer as 37, the values of the terminated column are referenced
+#else
+  std::cout << "35 - skipped, c_str_array.hpp is not available\n36 - skipped, c_str_array.hpp is not available\n37 - skipped, c_str_array.hpp is not available\n38 - skipped, c_str_array.hpp is not available\n";
+#endif
+
+#if __has_include("c_str_unescape.hpp")
+  std::cout << "39 I (3)";
+  print_builder(c_str::json_unescape_builder{ R"(A\u0042C)" }); // JSON escape sequence decoded into the owned buffer
+
+  std::cout << "40 I (3)";
+  print_builder(c_str::percent_decode_builder{ "A%42C" }); // percent-encoding decoded into the owned buffer
+
+  std::cout << "41 S (3)";
+  print_builder(c_str::c_unescape_builder{ strlit }); // nothing to be decoded, the string literal is referenced
+#else
+  std::cout << "39 - skipped, c_str_unescape.hpp is not available\n40 - skipped, c_str_unescape.hpp is not available\n41 - skipped, c_str_unescape.hpp is not available\n";
+#endif
+
+#if __has_include("c_str_builder_stream.hpp")
+  std::cout << "42 I (5)";
+  c_str::builder_ostream stream{}; // written into the small-string buffer of the stream first
+  stream << view << 42;
+  print_builder(stream.finish()); // the short string is copied into the small-string buffer of the object, nothing is allocated
+
+  std::cout << "43 Z (0)";
+  print_builder(stream.finish()); // nothing written since the last finish()
+#else
+  std::cout << "42 - skipped, c_str_builder_stream.hpp is not available\n43 - skipped, c_str_builder_stream.hpp is not available\n";
+#endif
+
+#if !defined(_WIN32) && __has_include("c_str_shm_arena.hpp")
+  auto arena{ c_str::shm_arena::create(1048576) };
+  arena.make_current();
+  std::cout << "44 C (3)";
+  const c_str::shm_builder shm{ view }; // copy in the shared memory arena
+  print_info(shm.get());
+
+  std::cout << "45 B (1)";
+  print_result(arena.resolve<char>(shm.handle()) == shm.get()); // the handle for a peer process resolves to the copy
+#else
+  std::cout << "44 - skipped on Windows, or c_str_shm_arena.hpp is not available\n45 - skipped on Windows, or c_str_shm_arena.hpp is not available\n";
+#endif
+
+#if defined(C_STR_BUILDER_TRACE) && __has_include("c_str_trace.hpp")
+  std::cout << "46 B (1)";
+  c_str::trace_recorder recorder{};
+  recorder.start();
+  {
+    const c_str::builder traced{ view };
+  }
+
+  recorder.stop();
+  print_result(recorder.records().size() == 2 && recorder.records()[0].op == c_str::trace_op::construct && recorder.records()[0].length == 3 && recorder.records()[1].op == c_str::trace_op::destroy); // the lifetime of the object is recorded
+#else
+  std::cout << "46 - skipped, C_STR_BUILDER_TRACE is not defined, or c_str_trace.hpp is not available\n";
+#endif
+
+  std::cout << "47 I (3)";
+  alignas(c_str::builder) unsigned char relocsrc[sizeof(c_str::builder)]; // uninitialized storage
+  alignas(c_str::builder) unsigned char relocdest[sizeof(c_str::builder)];
+  const auto relocated{ std::construct_at(reinterpret_cast<c_str::builder *>(relocsrc), view) };
+  print_builder(*relocated);
+
+  std::cout << "48 I (3)";
+  c_str::uninitialized_relocate(relocated, relocated + 1, reinterpret_cast<c_str::builder *>(relocdest)); // the small-string buffer is relocated along with the object
+  print_builder(*std::launder(reinterpret_cast<c_str::builder *>(relocdest)));
+  std::destroy_at(std::launder(reinterpret_cast<c_str::builder *>(relocdest)));
+
+#if __has_include("c_str_template_builder.hpp")
+  std::cout << "49 I (6)";
+  static constexpr c_str::basic_compiled_template compiled{ "{}-{}" }; // placeholders resolved at compile time
+  print_builder(compiled.build(view, 42));
+
+  std::cout << "50 C (6)";
+  c_str::template_builder filler{ compiled }; // reused buffer of the filled template
+  print_info(filler.fill(view, 42));
+
+  std::cout << "51 C (8)";
+  print_info(filler.fill(filler.view(), 1)); // the argument refers to the reused buffer, the template is filled into a new buffer
+#else
+  std::cout << "49 - skipped, c_str_template_builder.hpp is not available\n50 - skipped, c_str_template_builder.hpp is not available\n51 - skipped, c_str_template_builder.hpp is not available\n";
+#endif
+
+#if __has_include("c_str_builder_ref.hpp")
+  std::cout << "52 I (3)";
+  c_str::builder refsrc{ view };
+  print_builder(refsrc);
+
+  std::cout << "53 I (3)";
+  const c_str::builder_ref ref{ std::move(refsrc) }; // the owning builder is moved to the heap along with its small-string buffer
+  print_info(ref.get<char>());
+
+  std::cout << "54 B (1)";
+  const c_str::builder_ref tmpref{ c_str::builder{ std::string{ view } } }; // the builder refers to a temporary std::string, which is copied
+  print_result(tmpref.is_owning() && tmpref.view<char>() == view);
+#else
+  std::cout << "52 - skipped, c_str_builder_ref.hpp is not available\n53 - skipped, c_str_builder_ref.hpp is not available\n54 - skipped, c_str_builder_ref.hpp is not available\n";
+#endif
+
+#if __has_include("c_str_env_snapshot.hpp")
+#ifdef _WIN32
+  static_cast<void>(::_putenv_s("C_STR_TESTS", "ABC"));
+#else
+  static_cast<void>(::setenv("C_STR_TESTS", "ABC", 1));
+#endif
+  const c_str::env_snapshot env{}; // indexed copy of the environment block pointers
+  std::cout << "55 E (3)";
+  print_info(env.find(std::string_view{ "C_STR_TESTS" })); // value in the environment block, found without a terminated copy of the name
+
+  std::cout << "56 B (1)";
+  print_result(env.get("C_STR_TESTS") == view && !env.contains("C_STR_TESTS_UNSET"));
+#else
+  std::cout << "55 - skipped, c_str_env_snapshot.hpp is not available\n56 - skipped, c_str_env_snapshot.hpp is not available\n";
+#endif
+
+#if __has_include("c_str_static_string_map.hpp")
+  static constexpr auto handlers{ c_str::make_static_string_map<int>({ { "http_request_get_handler", 1 }, { "http_request_put_handler", 2 }, { "ABC", 3 } }) }; // perfect hash computed at compile time
+  std::cout << "57 B (1)";
+  print_result(handlers.find(view) && *handlers.find(view) == 3 && handlers.at("http_request_put_handler") == 2); // keys differing only in the middle are distinguished
+
+  std::cout << "58 B (1)";
+  print_result(!handlers.contains(static_cast<const char *>(nullptr)) && !handlers.contains("http_request_del_handler")); // a null pointer is never found
+#else
+  std::cout << "57 - skipped, c_str_static_string_map.hpp is not available\n58 - skipped, c_str_static_string_map.hpp is not available\n";
+#endif
+
+#if __has_include("c_str_sorted_array.hpp")
+  const std::array<const char *, 3> names{ "http_request_put_handler", strlit, "http_request_get_handler" };
+  const c_str::sorted_c_str_array table{ names, c_str::sorted_storage::reference }; // sorted pointers to the string literals
+  std::cout << "59 S (3)";
+  print_info(*table.find(view)); // the string literal is referenced
+
+  std::cout << "60 B (1)";
+  print_result(table[0] == strlit && table.length(2) == 24 && table.find(std::string_view{ "http_request_del_handler" }) == table.end() && !table.is_packed());
+#else
+  std::cout << "59 - skipped, c_str_sorted_array.hpp is not available\n60 - skipped, c_str_sorted_array.hpp is not available\n";
+#endif
+
+  std::cout << "61 B (1)";
+  const c_str::builder embedded{ std::string_view{ "AB\0C", 4 } }; // owned copy of all 4 characters, the length is determined with the first use
+  const auto embeddedcopy{ embedded };
+  print_result(embedded.hash() == std::hash<std::string_view>{}("AB") && embedded.length() == 2 && embeddedcopy == embedded && embeddedcopy.hash() == embedded.hash()); // the length and the hash value are cached
+
+  std::cout << "62 B (1)";
+  char prefixed[]{ "abcdefghXYZ" };
+  const c_str::builder prefix{ std::string_view{ prefixed, 8 } }; // small copy of a prefix, the out-of-line large-copy tier is not inlined here
+  print_result(prefix.view() == "abcdefgh" && prefix.is_owning());
+
+#if defined(C_STR_BUILDER_TRACE) && __has_include("c_str_trace.hpp")
+  std::cout << "63 B (1)";
+  std::atomic<bool> tracing{ true };
+  {
+    std::jthread worker{ [&tracing] {
+      while (tracing.load())
+        const c_str::builder traced{ view }; // calls the hook of a recorder which is concurrently stopped and destroyed
+    } };
+    for (int round{}; round < 200; ++round)
+    {
+      const auto shortLived{ std::make_unique<c_str::trace_recorder>() };
+      shortLived->start();
+      std::this_thread::yield();
+    } // stop() in the destructor waits for the hook calls in progress
+    tracing.store(false);
+  }
+
+  print_result(true); // AddressSanitizer reports a use after free otherwise
+#else
+  std::cout << "63 - skipped, C_STR_BUILDER_TRACE is not defined, or c_str_trace.hpp is not available\n";
+#endif
+
+#if __has_include("c_str_unescape.hpp")
+  std::cout << "64 B (1)";
+  print_result(c_str::form_decode_builder{ "a+b%2Bc+" }.view() == "a b+c " && c_str::form_decode_builder{ std::string_view{ "x+y" } }.view() == "x y"); // a decoded + is kept, + without any % is decoded as well
+
+  std::cout << "65 B (1)";
+  const c_str::percent_decode_builder embeddedNull{ "A%00B" };
+  print_result(embeddedNull.is_owning() && embeddedNull.length() == 1 && embeddedNull.get()[2] == 'B'); // the decoded null is kept in the buffer, but ends the C-string
+
+  std::cout << "66 I (3)";
+  print_builder(c_str::percent_decode_builder{ lst }); // nothing to be decoded, the contiguous copy of the std::list<char> is returned
+#else
+  std::cout << "64 - skipped, c_str_unescape.hpp is not available\n65 - skipped, c_str_unescape.hpp is not available\n66 - skipped, c_str_unescape.hpp is not available\n";
+#endif
+
+#if __has_include("c_str_builder_stream.hpp")
+  std::cout << "67 B (1)";
+  stream << view << 42;
+  const auto inlineBytes{ stream.finish().owned_bytes() };
+  stream << view << 1234567890123 << view; // exceeds the small-string buffer of the stream
+  const auto allocatedView{ stream.view() };
+  const auto allocated{ stream.finish() };
+  print_result(inlineBytes == 0 && allocated.get() == allocatedView.data() && allocated.view() == "ABC1234567890123ABC"); // the allocated buffer is taken over without copying
+#else
+  std::cout << "67 - skipped, c_str_builder_stream.hpp is not available\n";
+#endif
+
+#if __has_include("c_str_array.hpp")
+  std::cout << "68 B (1)";
+  const std::vector<std::string_view> manyviews(1000, std::string_view{ "ABCD" }.substr(0, 3)); // not null-terminated, copied into the blob
+  const c_str::c_str_array pararr{ std::execution::par, manyviews };
+  print_result(pararr.size() == 1000 && pararr[999] == pararr[0] + 999 * 4 && std::string_view{ pararr[999] } == "ABC" && !pararr.data()[1000]); // the offsets computed in the pointer slots are replaced by the pointers
+#else
+  std::cout << "68 - skipped, c_str_array.hpp is not available\n";
+#endif
+
+#if __has_include("c_str_memo_builder.hpp")
+  std::cout << "69 B (1)";
+  const c_str::memo_builder memoized{ std::string_view{ "AB\0C", 4 } };
+  print_result(memoized.length() == 4 && memoized.view() == std::string_view{ "AB\0C", 4 } && c_str::memo_builder{ view }.length() == 3); // the size of the cached copy, the copy is not searched for the terminating null
+#else
+  std::cout << "69 - skipped, c_str_memo_builder.hpp is not available\n";
+#endif
 }
 
 #if defined(__clang__)